@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+# Classificador de veículos do radar: treino offline e geração das tabelas C
+#
+#   train:    gera veículos rotulados, treina uma árvore de decisão (CART,
+#             índice de Gini) e grava o modelo em JSON
+#   generate: converte o modelo JSON em um header com tabelas constantes,
+#             chamado pelo CMake a cada build
+#   heldout:  converte o conjunto de avaliação fixo (veículos reais, CSV) em
+#             um header usado por tests/test_vehicle_classifier.c
+#
+# A validação do treino sorteia veículos das mesmas famílias do treino e só
+# mostra que elas são separáveis; a acurácia que importa é a do conjunto fixo
+# de veículos reais, que o treino avalia mas nunca usa para ajustar a árvore.
+#
+# A árvore é gravada completa até a profundidade máxima, em ordem de largura:
+# o nó i tem filhos 2i+1 e 2i+2, e a inferência percorre sempre o mesmo
+# número de níveis, sem ponteiros nem desvios dependentes dos dados.
+
+import argparse
+import hashlib
+import json
+import os
+import random
+import sys
+
+MAX_AXLES = 10
+
+FEATURES = ["axle_count", "length_mm", "speed_kmh"] + \
+           ["spacing_%d_mm" % (i + 1) for i in range(MAX_AXLES - 1)]
+
+CLASSES = ["VEHICLE_LIGHT", "VEHICLE_HEAVY"]
+
+# Famílias de veículos: classe e faixa de cada distância entre eixos (mm).
+# Não são ajustadas pelo conjunto de avaliação (vehicle_classifier_heldout.csv).
+FAMILIES = [
+    ("motocicleta",          "VEHICLE_LIGHT", [(1200, 1600)],               (30, 120)),
+    ("automovel",            "VEHICLE_LIGHT", [(2300, 2900)],               (30, 130)),
+    ("utilitario",           "VEHICLE_LIGHT", [(2900, 3700)],               (30, 120)),
+    ("automovel + reboque",  "VEHICLE_LIGHT", [(2300, 2900), (2800, 3800)], (30, 100)),
+    ("automovel + carretinha", "VEHICLE_LIGHT",
+     [(2300, 2900), (3000, 4000), (1000, 1300)],                            (30, 100)),
+    ("caminhao 2 eixos",     "VEHICLE_HEAVY", [(3900, 5500)],               (20, 90)),
+    ("onibus 2 eixos",       "VEHICLE_HEAVY", [(5500, 5900)],               (20, 90)),
+    ("caminhao 3 eixos",     "VEHICLE_HEAVY", [(4000, 5500), (1250, 1450)], (20, 90)),
+    ("onibus 3 eixos",       "VEHICLE_HEAVY", [(5000, 5900), (1300, 1500)], (20, 90)),
+    ("carreta 5 eixos",      "VEHICLE_HEAVY",
+     [(3300, 3800), (1250, 1400), (4500, 5800), (1250, 1400)],              (20, 90)),
+]
+
+HELDOUT_DEFAULT = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                               "vehicle_classifier_heldout.csv")
+
+# Erro relativo da medição de cada distância (tick de 100 us e velocidade
+# medida no primeiro eixo)
+SPACING_NOISE = 0.01
+
+
+def sample_vehicle(rng, family):
+    _, label, spacings, speeds = family
+    measured = [int(rng.uniform(lo, hi) * (1.0 + rng.uniform(-SPACING_NOISE, SPACING_NOISE)))
+                for lo, hi in spacings]
+    measured += [0] * (MAX_AXLES - 1 - len(measured))
+    features = [len(spacings) + 1, sum(measured), int(rng.uniform(*speeds))] + measured
+    return features, CLASSES.index(label)
+
+
+def load_heldout(path):
+    vehicles = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            name, label, speed, spacings = line.split(",")
+            vehicles.append((name, label, int(speed), [int(s) for s in spacings.split("/")]))
+    return vehicles
+
+
+def heldout_features(speed, spacings):
+    measured = spacings + [0] * (MAX_AXLES - 1 - len(spacings))
+    return [len(spacings) + 1, sum(spacings), speed] + measured
+
+
+def gini(counts):
+    total = sum(counts)
+    if total == 0:
+        return 0.0
+    return 1.0 - sum((c / total) ** 2 for c in counts)
+
+
+def best_split(samples, min_leaf):
+    best = None
+    parent = [0] * len(CLASSES)
+    for _, label in samples:
+        parent[label] += 1
+
+    for feature in range(len(FEATURES)):
+        ordered = sorted(samples, key=lambda s: s[0][feature])
+        left = [0] * len(CLASSES)
+        right = parent[:]
+        for i in range(len(ordered) - 1):
+            left[ordered[i][1]] += 1
+            right[ordered[i][1]] -= 1
+            value, following = ordered[i][0][feature], ordered[i + 1][0][feature]
+            if value == following or i + 1 < min_leaf or len(ordered) - i - 1 < min_leaf:
+                continue
+            n_left, n_right = i + 1, len(ordered) - i - 1
+            score = (n_left * gini(left) + n_right * gini(right)) / len(ordered)
+            if best is None or score < best[0]:
+                best = (score, feature, (value + following) // 2)
+
+    if best is None or best[0] >= gini(parent):
+        return None
+    return best[1], best[2]
+
+
+def majority(samples):
+    counts = [0] * len(CLASSES)
+    for _, label in samples:
+        counts[label] += 1
+    return counts.index(max(counts))
+
+
+def build(samples, depth, max_depth, min_leaf):
+    if depth == max_depth or len({label for _, label in samples}) == 1:
+        return {"leaf": majority(samples)}
+
+    split = best_split(samples, min_leaf)
+    if split is None:
+        return {"leaf": majority(samples)}
+
+    feature, threshold = split
+    left = [s for s in samples if s[0][feature] <= threshold]
+    right = [s for s in samples if s[0][feature] > threshold]
+    return {
+        "feature": feature,
+        "threshold": threshold,
+        "left": build(left, depth + 1, max_depth, min_leaf),
+        "right": build(right, depth + 1, max_depth, min_leaf),
+    }
+
+
+def predict(node, features):
+    while "leaf" not in node:
+        node = node["left"] if features[node["feature"]] <= node["threshold"] else node["right"]
+    return node["leaf"]
+
+
+def train(args):
+    rng = random.Random(args.seed)
+    samples = [sample_vehicle(rng, rng.choice(FAMILIES)) for _ in range(args.samples)]
+    tree = build(samples, 0, args.max_depth, args.min_leaf)
+
+    validation = [sample_vehicle(rng, rng.choice(FAMILIES)) for _ in range(args.samples)]
+    correct = sum(predict(tree, f) == label for f, label in validation)
+    print("Acuracia na validacao sintetica (mesmas familias): %d/%d" %
+          (correct, len(validation)), file=sys.stderr)
+
+    # Avaliado depois do treino, sem influenciar a árvore
+    heldout = load_heldout(args.heldout)
+    misses = [name for name, label, speed, spacings in heldout
+              if CLASSES[predict(tree, heldout_features(speed, spacings))] != label]
+    print("Acuracia nos veiculos reais: %d/%d" % (len(heldout) - len(misses), len(heldout)),
+          file=sys.stderr)
+    for name in misses:
+        print("  errado: %s" % name, file=sys.stderr)
+
+    with open(args.heldout, "rb") as f:
+        heldout_sha256 = hashlib.sha256(f.read()).hexdigest()
+
+    model = {
+        "seed": args.seed,
+        "samples": args.samples,
+        "max_depth": args.max_depth,
+        "features": FEATURES,
+        "classes": CLASSES,
+        "heldout": {
+            "file": os.path.basename(args.heldout),
+            "sha256": heldout_sha256,
+            "correct": len(heldout) - len(misses),
+            "total": len(heldout),
+            "misses": misses,
+        },
+        "tree": tree,
+    }
+    with open(args.output, "w") as f:
+        json.dump(model, f, indent=2)
+        f.write("\n")
+
+
+def flatten(node, index, depth, max_depth, features, thresholds, leaves):
+    if depth == max_depth:
+        leaves[index - (2 ** max_depth - 1)] = node["leaf"]
+        return
+
+    if "leaf" in node:
+        # Folha acima do último nível: replicada nos dois ramos
+        features[index], thresholds[index] = 0, 0xFFFF
+        left = right = node
+    else:
+        features[index], thresholds[index] = node["feature"], node["threshold"]
+        left, right = node["left"], node["right"]
+
+    flatten(left, 2 * index + 1, depth + 1, max_depth, features, thresholds, leaves)
+    flatten(right, 2 * index + 2, depth + 1, max_depth, features, thresholds, leaves)
+
+
+def tree_depth(node):
+    if "leaf" in node:
+        return 0
+    return 1 + max(tree_depth(node["left"]), tree_depth(node["right"]))
+
+
+def c_array(values, per_line=12):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generate(args):
+    with open(args.model) as f:
+        model = json.load(f)
+
+    depth = max(tree_depth(model["tree"]), 1)
+    internal = 2 ** depth - 1
+    features = [0] * internal
+    thresholds = [0] * internal
+    leaves = [0] * (2 ** depth)
+
+    flatten(model["tree"], 0, 0, depth, features, thresholds, leaves)
+
+    out = []
+    out.append("// Gerado por scripts/vehicle_classifier.py a partir de %s. Não editar." %
+               args.model_name)
+    out.append("#ifndef VEHICLE_CLASSIFIER_MODEL_H")
+    out.append("#define VEHICLE_CLASSIFIER_MODEL_H")
+    out.append("")
+    out.append("// Atributos de entrada, na ordem do modelo")
+    out.append("enum {")
+    for name in model["features"]:
+        out.append("    CLASSIFIER_F_%s," % name.upper())
+    out.append("    CLASSIFIER_FEATURE_COUNT")
+    out.append("};")
+    out.append("")
+    out.append("#define CLASSIFIER_DEPTH  %d" % depth)
+    out.append("")
+    out.append("// Nó i: atributo e limiar; filhos em 2i+1 (<=) e 2i+2 (>)")
+    out.append("static const uint8_t classifier_feature[%d] = {" % internal)
+    out.append(c_array(features))
+    out.append("};")
+    out.append("")
+    out.append("static const uint16_t classifier_threshold[%d] = {" % internal)
+    out.append(c_array(thresholds))
+    out.append("};")
+    out.append("")
+    out.append("static const uint8_t classifier_leaf[%d] = {" % len(leaves))
+    out.append(c_array([model["classes"][leaf] for leaf in leaves], per_line=4))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* VEHICLE_CLASSIFIER_MODEL_H */")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def generate_heldout(args):
+    vehicles = load_heldout(args.heldout)
+
+    out = []
+    out.append("// Gerado por scripts/vehicle_classifier.py a partir de %s. Não editar." %
+               os.path.basename(args.heldout))
+    out.append("#ifndef VEHICLE_CLASSIFIER_HELDOUT_H")
+    out.append("#define VEHICLE_CLASSIFIER_HELDOUT_H")
+    out.append("")
+    out.append("// X(nome, classe, velocidade em km/h, eixos, entre-eixos em mm...)")
+    out.append("#define CLASSIFIER_HELDOUT_VEHICLES(X) \\")
+    for name, label, speed, spacings in vehicles:
+        out.append("    X(\"%s\", %s, %d, %d, %s) \\" %
+                   (name, label, speed, len(spacings) + 1, ", ".join(str(s) for s in spacings)))
+    out.append("")
+    out.append("#endif /* VEHICLE_CLASSIFIER_HELDOUT_H */")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Classificador de veiculos do radar")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_train = sub.add_parser("train", help="treina o modelo (offline)")
+    p_train.add_argument("--samples", type=int, default=4000)
+    p_train.add_argument("--seed", type=int, default=2024)
+    p_train.add_argument("--max-depth", type=int, default=5)
+    p_train.add_argument("--min-leaf", type=int, default=5)
+    p_train.add_argument("--heldout", default=HELDOUT_DEFAULT)
+    p_train.add_argument("-o", "--output", required=True)
+    p_train.set_defaults(func=train)
+
+    p_gen = sub.add_parser("generate", help="gera o header C (build)")
+    p_gen.add_argument("model")
+    p_gen.add_argument("output")
+    p_gen.set_defaults(func=generate)
+
+    p_held = sub.add_parser("heldout", help="gera o header do conjunto de avaliação (build)")
+    p_held.add_argument("heldout")
+    p_held.add_argument("output")
+    p_held.set_defaults(func=generate_heldout)
+
+    args = parser.parse_args()
+    if args.command == "generate":
+        args.model_name = args.model.split("/")[-1]
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
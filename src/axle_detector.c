@@ -0,0 +1,323 @@
+#include "radar.h"
+
+// Fração do intervalo mínimo entre eixos usada como janela de debounce. Deve
+// ficar abaixo do menor intervalo entre o último eixo de um veículo e o
+// primeiro do seguinte que se quer separar.
+#define DEBOUNCE_AXLE_FRACTION_PERCENT  25
+
+// Tempo do primeiro eixo entre os sensores na velocidade máxima (us)
+#define MIN_TRANSIT_US  ((uint32_t)(((uint64_t)SENSOR_DISTANCE_MM * 3600U) / MAX_SPEED_KMH))
+
+// Tempo para percorrer distance_mm na velocidade medida pelo primeiro eixo
+static uint32_t travel_time_us(uint32_t distance_mm, uint32_t transit_us)
+{
+    return (uint32_t)(((uint64_t)distance_mm * transit_us) / SENSOR_DISTANCE_MM);
+}
+
+// Distância percorrida em elapsed_us na velocidade medida pelo primeiro eixo
+static uint16_t travel_distance_mm(uint32_t elapsed_us, uint32_t transit_us)
+{
+    uint64_t distance = ((uint64_t)elapsed_us * SENSOR_DISTANCE_MM) / transit_us;
+
+    return (uint16_t)MIN(distance, (uint64_t)UINT16_MAX);
+}
+
+uint32_t axle_debounce_window_us(uint32_t transit_us)
+{
+    // Antes de o primeiro eixo chegar ao sensor 2 assume a velocidade máxima,
+    // que dá a janela mais curta
+    uint32_t window = travel_time_us(MIN_AXLE_SPACING_MM, transit_us ? transit_us : MIN_TRANSIT_US) *
+                      DEBOUNCE_AXLE_FRACTION_PERCENT / 100U;
+
+    return CLAMP(window, (uint32_t)SENSOR_MIN_PULSE_US, DEBOUNCE_TIME_MS * 1000U);
+}
+
+// Silêncio após o qual o veículo é considerado encerrado
+static uint32_t axle_gap_timeout_us(uint32_t transit_us)
+{
+    uint32_t timeout = AXLE_TIMEOUT_MS * 1000U;
+
+    if (transit_us == 0) {
+        return timeout;
+    }
+
+    return MIN(travel_time_us(MAX_AXLE_SPACING_MM, transit_us), timeout);
+}
+
+// Um novo pulso no sensor 1 enquanto um eixo do veículo mais recente ainda está
+// entre os sensores só pode ser de outro veículo se os eixos forem mais
+// espaçados que os sensores; sem isso veículos sobrepostos seriam mesclados
+BUILD_ASSERT(MIN_AXLE_SPACING_MM > SENSOR_DISTANCE_MM,
+             "CONFIG_RADAR_MIN_AXLE_SPACING_MM deve ser maior que "
+             "CONFIG_RADAR_SENSOR_DISTANCE_MM");
+
+static uint32_t track_last_edge_us(const axle_track_t *track)
+{
+    if (track->sensor2_axles > 0 &&
+        (int32_t)(track->last_sensor2_us - track->last_sensor1_us) > 0) {
+        return track->last_sensor2_us;
+    }
+
+    return track->last_sensor1_us;
+}
+
+static axle_track_t *detector_track(axle_detector_t *det, uint8_t index)
+{
+    return &det->tracks[(det->head + index) % MAX_TRACKS_PER_LANE];
+}
+
+static axle_track_t *detector_newest(axle_detector_t *det)
+{
+    return det->count ? detector_track(det, det->count - 1) : NULL;
+}
+
+static void detector_pop(axle_detector_t *det)
+{
+    det->head = (det->head + 1) % MAX_TRACKS_PER_LANE;
+    det->count--;
+}
+
+// Descarta o veículo mais antigo, contando a câmera que ele deixou pré-armada
+static void detector_drop(axle_detector_t *det)
+{
+    if (det->tracks[det->head].infraction_predicted) {
+        det->dropped_predictions++;
+    }
+
+    detector_pop(det);
+    det->dropped_tracks++;
+}
+
+static void detector_open_track(axle_detector_t *det, uint32_t time_us)
+{
+    // Fila cheia: descarta o veículo mais antigo
+    if (det->count == MAX_TRACKS_PER_LANE) {
+        detector_drop(det);
+    }
+
+    axle_track_t *track = detector_track(det, det->count);
+
+    memset(track, 0, sizeof(*track));
+    track->sensor1_axles = 1;
+    track->sensor1_us[0] = time_us;
+    track->last_sensor1_us = time_us;
+    det->count++;
+}
+
+// Decide se um pulso aceito no sensor 1 inicia outro veículo
+static bool starts_new_vehicle(const axle_track_t *newest, uint32_t time_us)
+{
+    if (newest == NULL) {
+        return true;
+    }
+
+    if (newest->sensor2_axles < newest->sensor1_axles) {
+        return true;
+    }
+
+    return (time_us - newest->last_sensor1_us) >= axle_gap_timeout_us(newest->transit_us);
+}
+
+// Entre-eixos medidos no sensor 1; spacing_mm zerado além do último eixo
+static void track_spacing_mm(const axle_track_t *track, uint16_t spacing_mm[RADAR_MAX_AXLES - 1])
+{
+    memset(spacing_mm, 0, (RADAR_MAX_AXLES - 1) * sizeof(uint16_t));
+
+    for (uint8_t axle = 1; axle < track->sensor1_axles; axle++) {
+        spacing_mm[axle - 1] = travel_distance_mm(track->sensor1_us[axle] - track->sensor1_us[axle - 1],
+                                                  track->transit_us);
+    }
+}
+
+// Refaz a previsão com o limite da classe estimada pelos eixos já vistos no
+// sensor 1. Chamada com a velocidade já medida; uma previsão desfeita volta
+// se um eixo seguinte muda a classe.
+static axle_edge_t track_predict(axle_track_t *track)
+{
+    uint16_t spacing_mm[RADAR_MAX_AXLES - 1];
+
+    track_spacing_mm(track, spacing_mm);
+
+    vehicle_type_t type = classify_vehicle_partial(track->sensor1_axles, spacing_mm,
+                                                   track->transit_us);
+    bool predicted = speed_transit_exceeds_limit(track->transit_us, type);
+
+    if (predicted == track->infraction_predicted) {
+        return AXLE_EDGE_ACCEPTED;
+    }
+
+    track->infraction_predicted = predicted;
+    return predicted ? AXLE_EDGE_SPEEDING : AXLE_EDGE_CLEARED;
+}
+
+void axle_detector_init(axle_detector_t *det)
+{
+    memset(det, 0, sizeof(*det));
+}
+
+axle_edge_t axle_detector_edge(axle_detector_t *det, radar_sensor_t sensor, uint32_t time_us)
+{
+    axle_track_t *newest = detector_newest(det);
+
+    if (sensor == RADAR_SENSOR_1) {
+        // Repique do sensor
+        if (newest != NULL &&
+            (time_us - newest->last_sensor1_us) < axle_debounce_window_us(newest->transit_us)) {
+            return AXLE_EDGE_IGNORED;
+        }
+
+        if (starts_new_vehicle(newest, time_us)) {
+            detector_open_track(det, time_us);
+            return AXLE_EDGE_ACCEPTED;
+        }
+
+        if (newest->sensor1_axles < RADAR_MAX_AXLES) {
+            newest->sensor1_us[newest->sensor1_axles++] = time_us;
+        }
+        newest->last_sensor1_us = time_us;
+
+        // Cada eixo novo pode separar as classes e trocar o limite
+        return newest->transit_us ? track_predict(newest) : AXLE_EDGE_ACCEPTED;
+    }
+
+    // Sensor 2: pertence ao veículo mais antigo com eixos entre os sensores
+    axle_track_t *track = NULL;
+
+    for (uint8_t i = 0; i < det->count; i++) {
+        axle_track_t *candidate = detector_track(det, i);
+
+        // Veículos parados além do timeout já estão abandonados
+        if ((time_us - track_last_edge_us(candidate)) >= AXLE_TIMEOUT_MS * 1000U) {
+            continue;
+        }
+
+        if (candidate->sensor2_axles < candidate->sensor1_axles) {
+            track = candidate;
+            break;
+        }
+    }
+
+    if (track == NULL) {
+        return AXLE_EDGE_IGNORED;
+    }
+
+    if ((time_us - det->last_sensor2_us) < axle_debounce_window_us(track->transit_us)) {
+        return AXLE_EDGE_IGNORED;
+    }
+
+    track->sensor2_axles++;
+    track->last_sensor2_us = time_us;
+    det->last_sensor2_us = time_us;
+
+    if (track->sensor2_axles > 1) {
+        return AXLE_EDGE_ACCEPTED;
+    }
+
+    // O primeiro eixo no sensor 2 fornece a velocidade do veículo. Com um só
+    // eixo no sensor 1 a classe não é conhecida e a previsão usa o menor
+    // limite; os eixos seguintes refinam a previsão, e a decisão confirma ou
+    // libera a câmera depois.
+    track->transit_us = MAX(time_us - track->sensor1_us[0], 1U);
+
+    return track_predict(track);
+}
+
+uint32_t axle_detector_poll_delay_us(const axle_detector_t *det, uint32_t now_us)
+{
+    if (det->count == 0) {
+        return 0;
+    }
+
+    const axle_track_t *track = &det->tracks[det->head];
+    uint32_t elapsed = now_us - track_last_edge_us(track);
+    uint32_t timeout;
+
+    if (track->sensor2_axles == track->sensor1_axles) {
+        // Outro veículo já começou: nenhum eixo novo pode chegar a este
+        if (det->count > 1) {
+            return 0;
+        }
+        timeout = axle_gap_timeout_us(track->transit_us);
+    } else {
+        timeout = AXLE_TIMEOUT_MS * 1000U;
+    }
+
+    return (elapsed < timeout) ? (timeout - elapsed) : 0;
+}
+
+// A classificação fica para o estágio de decisão, fora da interrupção: aqui
+// só são registradas as medidas do veículo
+static void track_to_vehicle(const axle_track_t *track, vehicle_data_t *vehicle)
+{
+    uint32_t length_mm = 0;
+
+    memset(vehicle, 0, sizeof(*vehicle));
+    track_spacing_mm(track, vehicle->axle_spacing_mm);
+    vehicle->time_between_sensors_us = track->transit_us;
+    vehicle->time_between_sensors = track->transit_us / 1000U;
+    vehicle->total_passage_time = (track->last_sensor2_us - track->sensor1_us[0]) / 1000U;
+    vehicle->axle_count = track->sensor1_axles;
+    vehicle->direction = DIRECTION_FORWARD;
+    vehicle->valid_measurement = true;
+    vehicle->type = VEHICLE_UNKNOWN;
+    vehicle->sensor2_us = track->sensor1_us[0] + track->transit_us;
+    vehicle->infraction_predicted = track->infraction_predicted;
+
+    for (uint8_t axle = 1; axle < track->sensor1_axles; axle++) {
+        length_mm += vehicle->axle_spacing_mm[axle - 1];
+    }
+    vehicle->length_mm = (uint16_t)MIN(length_mm, (uint32_t)UINT16_MAX);
+}
+
+// Instante em que o veículo mais antigo ficou completo: o silêncio após a
+// última borda ou, se antes disso, a primeira borda do veículo seguinte
+static uint32_t track_ready_us(axle_detector_t *det, const axle_track_t *track)
+{
+    uint32_t last_us = track_last_edge_us(track);
+
+    if (det->count > 1) {
+        uint32_t next_us = detector_track(det, 1)->sensor1_us[0];
+
+        return ((int32_t)(next_us - last_us) > 0) ? next_us : last_us;
+    }
+
+    return last_us + axle_gap_timeout_us(track->transit_us);
+}
+
+// Entrega, em ordem de chegada, o próximo veículo que terminou de passar.
+// Deve ser chamada até retornar false.
+bool axle_detector_poll(axle_detector_t *det, uint32_t now_us, vehicle_data_t *vehicle)
+{
+    while (det->count > 0) {
+        axle_track_t *track = &det->tracks[det->head];
+
+        if (axle_detector_poll_delay_us(det, now_us) > 0) {
+            return false;
+        }
+
+        if (track->sensor2_axles == track->sensor1_axles) {
+            track_to_vehicle(track, vehicle);
+            vehicle->ready_us = track_ready_us(det, track);
+            vehicle->last_edge_us = track_last_edge_us(track);
+            detector_pop(det);
+            return true;
+        }
+
+        // Eixos sem passagem pelo sensor 2 até o timeout: veículo abandonado
+        RADAR_DBG("Veiculo descartado: %u de %u eixo(s) no sensor 2",
+                  track->sensor2_axles, track->sensor1_axles);
+        detector_drop(det);
+    }
+
+    return false;
+}
+
+// Veículos descartados desde a última chamada que tinham pré-armado a
+// câmera. Cada um deve liberar os quadros presos da faixa.
+uint32_t axle_detector_take_dropped_predictions(axle_detector_t *det)
+{
+    uint32_t dropped = det->dropped_predictions;
+
+    det->dropped_predictions = 0;
+    return dropped;
+}
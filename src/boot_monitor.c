@@ -0,0 +1,54 @@
+#include "radar.h"
+
+// Instantes de boot em us de radar_now_us(), desde o início do contador de
+// ciclos do hardware. No SysTick (Cortex-M) ele começa com o driver de timer
+// do kernel, e o tempo entre o reset e esse ponto (ROM de boot, cópia de
+// dados) não entra; no timer genérico ARM ele pode incluir esse tempo. Zero
+// enquanto o evento não aconteceu.
+static uint32_t boot_armed_us;
+static atomic_t boot_first_vehicle_us;
+
+void radar_boot_mark_armed(void)
+{
+    boot_armed_us = MAX(radar_now_us(), 1U);
+}
+
+// Chamada pelo estágio de decisão a cada veículo; só o primeiro é registrado
+void radar_boot_mark_vehicle(void)
+{
+    if (atomic_get(&boot_first_vehicle_us) == 0) {
+        atomic_cas(&boot_first_vehicle_us, 0, MAX(radar_now_us(), 1U));
+    }
+}
+
+uint32_t radar_boot_armed_us(void)
+{
+    return boot_armed_us;
+}
+
+uint32_t radar_boot_first_vehicle_us(void)
+{
+    return (uint32_t)atomic_get(&boot_first_vehicle_us);
+}
+
+void radar_boot_report(void)
+{
+    uint32_t armed_us = radar_boot_armed_us();
+    uint32_t vehicle_us = radar_boot_first_vehicle_us();
+
+    if (armed_us == 0) {
+        RADAR_ERR("[BOOT] Sensores nao armados");
+        return;
+    }
+
+    if (vehicle_us == 0) {
+        RADAR_INFO("[BOOT] Desde o inicio do relogio: sensores armados em %u.%03u ms, "
+                   "nenhum veiculo processado",
+                   armed_us / 1000U, armed_us % 1000U);
+        return;
+    }
+
+    RADAR_INFO("[BOOT] Desde o inicio do relogio: sensores armados em %u.%03u ms, "
+               "primeiro veiculo em %u.%03u ms",
+               armed_us / 1000U, armed_us % 1000U, vehicle_us / 1000U, vehicle_us % 1000U);
+}
@@ -1,36 +1,190 @@
 #include "radar.h"
 
-void camera_thread(void *arg1, void *arg2, void *arg3)
+// Capturas pendentes, enfileiradas pelo listener de camera_trigger_chan
+K_MSGQ_DEFINE(camera_request_queue, sizeof(vehicle_data_t), 4, 4);
+
+static vehicle_data_t camera_vehicle;
+static uint32_t camera_start_time;
+static bool camera_busy;
+
+static void camera_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(camera_work, camera_work_handler);
+
+// Pré-disparo: o estágio de sensores prende os quadros da faixa na borda em
+// que prevê a infração; a decisão usa esses quadros ou os libera
+static atomic_t camera_pinned[RADAR_NUM_LANES];
+static atomic_t prearm_count;
+static atomic_t prearm_released[CAMERA_RELEASE_COUNT];
+
+// Pior tempo da borda que previu a infração até a câmera ser armada pelo
+// pré-disparo, e da borda do primeiro eixo no sensor 2 até a câmera ser
+// armada pelo estágio de decisão, o caminho sem pré-disparo
+static atomic_t prearm_worst_us;
+static atomic_t trigger_worst_us;
+
+static void camera_latency_update(atomic_t *worst_us, uint32_t edge_us)
+{
+    uint32_t latency = radar_now_us() - edge_us;
+    atomic_val_t worst;
+
+    // Pré-disparo e decisão podem atualizar ao mesmo tempo em CPUs diferentes
+    do {
+        worst = atomic_get(worst_us);
+        if (latency <= (uint32_t)worst) {
+            break;
+        }
+    } while (!atomic_cas(worst_us, worst, latency));
+}
+
+// Chamada na interrupção do sensor que previu a infração
+void radar_camera_prearm(uint8_t lane, uint32_t edge_us)
+{
+    atomic_inc(&camera_pinned[lane]);
+    atomic_inc(&prearm_count);
+    camera_latency_update(&prearm_worst_us, edge_us);
+}
+
+// Pré-disparo sem captura; os desfeitos na borda e os não confirmados pela
+// decisão são os falsos pré-disparos
+void radar_camera_release(uint8_t lane, camera_release_t reason)
 {
-    ARG_UNUSED(arg1);
-    ARG_UNUSED(arg2);
-    ARG_UNUSED(arg3);
+    atomic_dec(&camera_pinned[lane]);
+    atomic_inc(&prearm_released[reason]);
+}
 
-    bool trigger;
+uint32_t radar_camera_prearm_count(void)
+{
+    return (uint32_t)atomic_get(&prearm_count);
+}
+
+uint32_t radar_camera_released_count(camera_release_t reason)
+{
+    return (uint32_t)atomic_get(&prearm_released[reason]);
+}
+
+uint32_t radar_camera_prearm_worst_us(void)
+{
+    return (uint32_t)atomic_get(&prearm_worst_us);
+}
+
+uint32_t radar_camera_trigger_worst_us(void)
+{
+    return (uint32_t)atomic_get(&trigger_worst_us);
+}
+
+static void camera_finish_capture(void)
+{
     camera_data_t camera_data;
 
-    while (1) {
-        // Aguarda trigger da câmera
-        if (zbus_chan_read(&camera_trigger_chan, &trigger, K_FOREVER) == 0) {
-            if (trigger) {
-                printf(COLOR_BLUE "Camera: Capturando placa...\n" COLOR_NORMAL);
-                
-                // Simula processamento
-                k_sleep(K_MSEC(500));
-                
-                // Simula captura da placa (com possibilidade de falha)
-                simulate_license_plate(camera_data.plate, &camera_data.valid);
-                camera_data.captured = true;
-                
-                printf(COLOR_BLUE "Camera: Placa %s capturada - %s\n" COLOR_NORMAL,
-                       camera_data.plate,
-                       camera_data.valid ? "Valida" : "Invalida");
-                
-                // Publica resultado
-                zbus_chan_pub(&camera_result_chan, &camera_data, K_MSEC(250));
-            }
+    // Simula captura da placa (com possibilidade de falha)
+    simulate_license_plate(camera_data.plate, &camera_data.valid);
+    camera_data.captured = true;
+    // Com pré-disparo, a placa vem dos quadros presos na borda do sensor 2
+    camera_data.capture_time = camera_vehicle.infraction_predicted ?
+                               radar_us_to_uptime_ms(camera_vehicle.sensor2_us) :
+                               k_uptime_get_32();
+    camera_data.vehicle_type = camera_vehicle.type;
+    camera_data.vehicle_speed = camera_vehicle.speed_kmh;
+
+    // Publica resultado
+    zbus_chan_pub(&camera_result_chan, &camera_data, K_MSEC(250));
+
+    radar_deadline_end(RADAR_STAGE_CAMERA, camera_vehicle.release_time);
+
+    printf(COLOR_BLUE "Camera: Placa %s capturada - %s\n" COLOR_NORMAL,
+           camera_data.plate,
+           camera_data.valid ? "Valida" : "Invalida");
+}
+
+// Estágio da câmera: o processamento simulado é um reagendamento,
+// não um k_sleep, para não bloquear o display na mesma fila
+static void camera_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    radar_pipeline_count_dispatch();
+
+    if (camera_busy) {
+        uint32_t elapsed = k_uptime_get_32() - camera_start_time;
+
+        // Acionada por um novo disparo antes do fim do processamento
+        if (elapsed < CAMERA_PROCESSING_TIME_MS) {
+            k_work_schedule_for_queue(&radar_output_q, &camera_work,
+                                      K_MSEC(CAMERA_PROCESSING_TIME_MS - elapsed));
+            return;
         }
+
+        camera_finish_capture();
+        camera_busy = false;
+    }
+
+    if (k_msgq_get(&camera_request_queue, &camera_vehicle, K_NO_WAIT) == 0) {
+        radar_deadline_begin(RADAR_STAGE_CAMERA, camera_vehicle.release_time);
+
+        printf(COLOR_RED "INFRACAO DETECTADA! " COLOR_NORMAL);
+        printf("Veiculo: %s, Velocidade: %.1f km/h\n",
+               camera_vehicle.type == VEHICLE_LIGHT ? "Leve" : "Pesado",
+               camera_vehicle.speed_kmh);
+        printf(COLOR_BLUE "Camera: Capturando placa...\n" COLOR_NORMAL);
+
+        camera_busy = true;
+        camera_start_time = k_uptime_get_32();
+        k_work_schedule_for_queue(&radar_output_q, &camera_work,
+                                  K_MSEC(CAMERA_PROCESSING_TIME_MS));
     }
 }
 
-K_THREAD_DEFINE(camera_thread_id, 2048, camera_thread, NULL, NULL, NULL, 3, 0, 0);
\ No newline at end of file
+// Executado no contexto de quem publica (estágio de decisão)
+static void camera_trigger_listener(const struct zbus_channel *chan)
+{
+    const vehicle_data_t *vehicle = zbus_chan_const_msg(chan);
+
+    if (vehicle->sensor2_us != 0) {
+        camera_latency_update(&trigger_worst_us, vehicle->sensor2_us);
+    }
+
+    // Os quadros presos passam para a captura
+    if (vehicle->infraction_predicted) {
+        atomic_dec(&camera_pinned[vehicle->lane]);
+    }
+
+    if (k_msgq_put(&camera_request_queue, vehicle, K_NO_WAIT) != 0) {
+        RADAR_WARN("Fila da camera cheia, captura descartada");
+        return;
+    }
+
+    k_work_schedule_for_queue(&radar_output_q, &camera_work, K_NO_WAIT);
+}
+
+ZBUS_LISTENER_DEFINE(camera_listener, camera_trigger_listener);
+
+// Chamada após o início da fila de saída: atende capturas pedidas antes dele
+void radar_camera_start(void)
+{
+    if (k_msgq_num_used_get(&camera_request_queue) > 0) {
+        k_work_schedule_for_queue(&radar_output_q, &camera_work, K_NO_WAIT);
+    }
+}
+
+void radar_camera_report(void)
+{
+    uint32_t pinned = 0;
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        pinned += (uint32_t)atomic_get(&camera_pinned[lane]);
+    }
+
+    uint32_t prearms = radar_camera_prearm_count();
+    uint32_t edge = radar_camera_released_count(CAMERA_RELEASE_EDGE);
+    uint32_t decision = radar_camera_released_count(CAMERA_RELEASE_DECISION);
+    uint32_t false_x100 = prearms ? ((edge + decision) * 10000U) / prearms : 0;
+
+    RADAR_INFO("[CAMERA] Pre-disparos: %u, %u veiculo(s) com quadros presos",
+               prearms, pinned);
+    RADAR_INFO("[CAMERA] Falsos pre-disparos: %u.%02u%% (%u desfeitos na borda, %u pela decisao), "
+               "%u descartados",
+               false_x100 / 100U, false_x100 % 100U, edge, decision,
+               radar_camera_released_count(CAMERA_RELEASE_DROPPED));
+    RADAR_INFO("[CAMERA] Borda -> camera armada: pre-disparo pior %u us, decisao pior %u us",
+               radar_camera_prearm_worst_us(), radar_camera_trigger_worst_us());
+}
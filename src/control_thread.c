@@ -1,52 +1,111 @@
 #include "radar.h"
 
-// Fila para dados do veículo
-K_MSGQ_DEFINE(vehicle_data_queue, sizeof(vehicle_data_t), 10, 4);
+// Cada faixa tem sua própria fila de veículos e sua thread de decisão, de
+// forma que faixas em CPUs diferentes não compartilham locks
+typedef struct {
+    struct k_msgq queue;
+} lane_decision_t;
 
-void control_thread(void *arg1, void *arg2, void *arg3)
+static char __aligned(4) lane_queue_buffers[RADAR_NUM_LANES]
+                                           [MAX_VEHICLE_QUEUE_SIZE * sizeof(vehicle_data_t)];
+static lane_decision_t lane_decisions[RADAR_NUM_LANES];
+
+#ifdef CONFIG_ZTEST
+// Gancho dos testes, chamado a cada veículo decidido; nulo fora deles
+static radar_decision_hook_t decision_test_hook;
+
+void radar_decision_set_test_hook(radar_decision_hook_t hook)
 {
-    ARG_UNUSED(arg1);
-    ARG_UNUSED(arg2);
-    ARG_UNUSED(arg3);
+    decision_test_hook = hook;
+}
+#endif
 
-    vehicle_data_t vehicle_data;
-    camera_data_t camera_data;
-    bool camera_trigger = true;
+// Estágio de decisão: decide um veículo e encadeia os estágios de saída
+static void decide_vehicle(vehicle_data_t *vehicle_data)
+{
+    radar_deadline_begin(RADAR_STAGE_DECISION, vehicle_data->release_time);
 
-    while (1) {
-        // Aguarda dados do veículo
-        if (k_msgq_get(&vehicle_data_queue, &vehicle_data, K_FOREVER) == 0) {
-            
-            // Calcula velocidade
-            calculate_speed(&vehicle_data);
-            
-            // Verifica status da velocidade
-            speed_status_t status = check_speed_status(vehicle_data.speed_kmh, 
-                                                     vehicle_data.type);
-            
-            // Se for infração, aciona a câmera
-            if (status == SPEED_INFRACTION) {
-                printf(COLOR_RED "INFRACAO DETECTADA! " COLOR_NORMAL);
-                printf("Veiculo: %s, Velocidade: %.1f km/h\n",
-                       vehicle_data.type == VEHICLE_LIGHT ? "Leve" : "Pesado",
-                       vehicle_data.speed_kmh);
-                
-                // Dispara câmera via ZBUS
-                zbus_chan_pub(&camera_trigger_chan, &camera_trigger, K_MSEC(250));
-                
-                // Aguarda resultado da câmera
-                if (zbus_chan_read(&camera_result_chan, &camera_data, K_MSEC(1000)) == 0) {
-                    if (camera_data.captured) {
-                        printf("Placa: %s - %s\n", 
-                               camera_data.plate,
-                               camera_data.valid ? "VALIDA" : "INVALIDA");
-                    }
-                }
+    // Calcula velocidade
+    calculate_speed(vehicle_data);
+
+    // Classifica veículos que chegam do sensor sem tipo
+    if (vehicle_data->type == VEHICLE_UNKNOWN) {
+        vehicle_data->type = classify_vehicle(vehicle_data);
+    }
+
+    // Verifica status da velocidade
+    speed_status_t status = vehicle_speed_status(vehicle_data);
+
+#ifdef CONFIG_ZTEST
+    radar_decision_hook_t hook = decision_test_hook;
+
+    if (hook != NULL) {
+        hook(vehicle_data);
+    }
+#endif
+
+    // Se for infração, aciona a câmera sem bloquear a decisão:
+    // o resultado é publicado pela própria câmera
+    if (status == SPEED_INFRACTION) {
+        if (zbus_chan_pub(&camera_trigger_chan, vehicle_data, K_NO_WAIT) != 0) {
+            RADAR_WARN("Camera ocupada, captura descartada");
+            if (vehicle_data->infraction_predicted) {
+                radar_camera_release(vehicle_data->lane, CAMERA_RELEASE_DROPPED);
             }
         }
-        
-        k_sleep(K_MSEC(10));
+    } else if (vehicle_data->infraction_predicted) {
+        // Previsão da borda não confirmada, por exemplo um veículo leve
+        // entre o limite de pesados e o de leves que a estratégia de
+        // classificação só separa no fim da passagem
+        radar_camera_release(vehicle_data->lane, CAMERA_RELEASE_DECISION);
+    }
+
+    update_system_stats(vehicle_data->type, status == SPEED_INFRACTION, false);
+
+    radar_deadline_end(RADAR_STAGE_DECISION, vehicle_data->release_time);
+    if (vehicle_data->last_edge_time != 0) {
+        radar_deadline_end(RADAR_STAGE_EDGE_DECISION, vehicle_data->last_edge_time);
+    }
+    radar_boot_mark_vehicle();
+
+    // Encaminha para o display
+    radar_display_submit(vehicle_data);
+}
+
+// Thread de decisão da faixa: bloqueia na fila vazia e, ao acordar,
+// esvazia a fila antes de bloquear de novo
+void radar_decision_thread(void *p1, void *p2, void *p3)
+{
+    lane_decision_t *lane = &lane_decisions[POINTER_TO_UINT(p1)];
+    vehicle_data_t vehicle_data;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1) {
+        k_msgq_get(&lane->queue, &vehicle_data, K_FOREVER);
+        radar_pipeline_count_dispatch();
+
+        do {
+            decide_vehicle(&vehicle_data);
+        } while (k_msgq_get(&lane->queue, &vehicle_data, K_NO_WAIT) == 0);
     }
 }
 
-K_THREAD_DEFINE(control_thread_id, 2048, control_thread, NULL, NULL, NULL, 5, 0, 0);
\ No newline at end of file
+void radar_decision_init(void)
+{
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        k_msgq_init(&lane_decisions[lane].queue, lane_queue_buffers[lane],
+                    sizeof(vehicle_data_t), MAX_VEHICLE_QUEUE_SIZE);
+    }
+}
+
+int radar_pipeline_submit(const vehicle_data_t *vehicle)
+{
+    if (vehicle->lane >= RADAR_NUM_LANES) {
+        return -EINVAL;
+    }
+
+    // Pode ser chamada a partir de interrupções; acorda a thread da faixa
+    return k_msgq_put(&lane_decisions[vehicle->lane].queue, vehicle, K_NO_WAIT);
+}
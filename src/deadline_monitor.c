@@ -0,0 +1,118 @@
+#include "radar.h"
+
+// Prazo relativo de cada estágio (ms a partir de release_time do veículo;
+// borda->decisao a partir de last_edge_time)
+static const uint32_t stage_deadline_ms[RADAR_STAGE_COUNT] = {
+    [RADAR_STAGE_DECISION] = DEADLINE_DECISION_MS,
+    [RADAR_STAGE_DISPLAY]  = DEADLINE_DISPLAY_MS,
+    [RADAR_STAGE_CAMERA]   = DEADLINE_CAMERA_MS,
+    [RADAR_STAGE_EDGE_DECISION] = DEADLINE_EDGE_DECISION_MS,
+};
+
+// Com o processamento da câmera maior que o prazo, toda captura perderia o prazo
+BUILD_ASSERT(CAMERA_PROCESSING_TIME_MS < DEADLINE_CAMERA_MS,
+             "CONFIG_RADAR_DEADLINE_CAMERA_MS deve ser maior que "
+             "CONFIG_RADAR_CAMERA_PROCESSING_TIME_MS");
+
+static const char *stage_names[RADAR_STAGE_COUNT] = {
+    [RADAR_STAGE_DECISION] = "decisao",
+    [RADAR_STAGE_DISPLAY]  = "display",
+    [RADAR_STAGE_CAMERA]   = "camera",
+    [RADAR_STAGE_EDGE_DECISION] = "borda->decisao",
+};
+
+// Contadores atômicos por CPU: atualizados sem mutex e sem disputar
+// linhas de cache entre as faixas fixadas em CPUs diferentes
+typedef struct {
+    atomic_t misses[RADAR_STAGE_COUNT];
+    atomic_t completed[RADAR_STAGE_COUNT];
+    atomic_t worst_ms[RADAR_STAGE_COUNT];
+} __aligned(RADAR_CACHE_LINE_SIZE) deadline_shard_t;
+
+static deadline_shard_t deadline_shards[RADAR_NUM_CPUS];
+
+void radar_deadline_begin(radar_stage_t stage, uint32_t release_time)
+{
+#if defined(CONFIG_SCHED_DEADLINE)
+    // Repassa o tempo restante até o prazo para o escalonador EDF
+    uint32_t elapsed = k_uptime_get_32() - release_time;
+    uint32_t remaining = (elapsed < stage_deadline_ms[stage]) ?
+                         (stage_deadline_ms[stage] - elapsed) : 1;
+
+    k_thread_deadline_set(k_current_get(), k_ms_to_cyc_ceil32(remaining));
+#else
+    ARG_UNUSED(stage);
+    ARG_UNUSED(release_time);
+#endif
+}
+
+bool radar_deadline_end(radar_stage_t stage, uint32_t release_time)
+{
+    deadline_shard_t *shard = &deadline_shards[radar_cpu_id()];
+    uint32_t latency = k_uptime_get_32() - release_time;
+    atomic_val_t worst;
+
+    atomic_inc(&shard->completed[stage]);
+
+    // Atualiza o pior caso observado
+    do {
+        worst = atomic_get(&shard->worst_ms[stage]);
+        if (latency <= (uint32_t)worst) {
+            break;
+        }
+    } while (!atomic_cas(&shard->worst_ms[stage], worst, latency));
+
+    if (latency > stage_deadline_ms[stage]) {
+        atomic_inc(&shard->misses[stage]);
+        RADAR_DBG("Prazo perdido no estagio %s: %u ms (prazo %u ms)",
+                  stage_names[stage], latency, stage_deadline_ms[stage]);
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t radar_deadline_misses(radar_stage_t stage)
+{
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        total += atomic_get(&deadline_shards[cpu].misses[stage]);
+    }
+
+    return total;
+}
+
+uint32_t radar_deadline_completed(radar_stage_t stage)
+{
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        total += atomic_get(&deadline_shards[cpu].completed[stage]);
+    }
+
+    return total;
+}
+
+uint32_t radar_deadline_worst_ms(radar_stage_t stage)
+{
+    uint32_t worst = 0;
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        worst = MAX(worst, (uint32_t)atomic_get(&deadline_shards[cpu].worst_ms[stage]));
+    }
+
+    return worst;
+}
+
+void radar_deadline_report(void)
+{
+    for (int stage = 0; stage < RADAR_STAGE_COUNT; stage++) {
+        RADAR_INFO("[PRAZOS] %s: prazo %u ms, concluidos %u, perdidos %u, pior %u ms",
+                   stage_names[stage],
+                   stage_deadline_ms[stage],
+                   radar_deadline_completed(stage),
+                   radar_deadline_misses(stage),
+                   radar_deadline_worst_ms(stage));
+    }
+}
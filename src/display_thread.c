@@ -38,35 +38,126 @@ void update_display(float speed, vehicle_type_t type, speed_status_t status)
     printf("Status: %s%s%s\n\n", color, status_text, COLOR_NORMAL);
 }
 
-void display_thread(void *arg1, void *arg2, void *arg3)
+// Filas de veículos já decididos, uma por faixa, consumidas em rodízio
+static char __aligned(4) display_queue_buffers[RADAR_NUM_LANES]
+                                              [MAX_VEHICLE_QUEUE_SIZE * sizeof(vehicle_data_t)];
+static struct k_msgq display_queues[RADAR_NUM_LANES];
+static uint8_t next_display_lane;
+
+static uint32_t last_update_time;
+static bool display_updated;
+static speed_status_t last_status = SPEED_NORMAL;
+
+static void display_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(display_work, display_work_handler);
+
+static bool display_next_vehicle(vehicle_data_t *vehicle_data)
 {
-    ARG_UNUSED(arg1);
-    ARG_UNUSED(arg2);
-    ARG_UNUSED(arg3);
+    for (uint8_t i = 0; i < RADAR_NUM_LANES; i++) {
+        uint8_t lane = (next_display_lane + i) % RADAR_NUM_LANES;
 
+        if (k_msgq_get(&display_queues[lane], vehicle_data, K_NO_WAIT) == 0) {
+            next_display_lane = (lane + 1) % RADAR_NUM_LANES;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool display_has_pending(void)
+{
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        if (k_msgq_num_used_get(&display_queues[lane]) > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Estágio de display: mostra um veículo por intervalo de atualização
+static void display_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    vehicle_data_t vehicle_data;
+    uint32_t elapsed = k_uptime_get_32() - last_update_time;
+
+    radar_pipeline_count_dispatch();
+
+    // Respeita o intervalo mínimo entre atualizações
+    if (display_updated && elapsed < DISPLAY_UPDATE_INTERVAL_MS) {
+        k_work_schedule_for_queue(&radar_output_q, &display_work,
+                                  K_MSEC(DISPLAY_UPDATE_INTERVAL_MS - elapsed));
+        return;
+    }
+
+    if (!display_next_vehicle(&vehicle_data)) {
+        return;
+    }
+
+    radar_deadline_begin(RADAR_STAGE_DISPLAY, vehicle_data.release_time);
+
+    speed_status_t current_status = vehicle_speed_status(&vehicle_data);
+    
+    // Atualiza display apenas se houve mudança
+    if (current_status != last_status || vehicle_data.speed_kmh > 0) {
+        update_display(vehicle_data.speed_kmh, vehicle_data.type, current_status);
+        last_status = current_status;
+    }
+
+    radar_deadline_end(RADAR_STAGE_DISPLAY, vehicle_data.release_time);
+
+    last_update_time = k_uptime_get_32();
+    display_updated = true;
+
+    // Ainda há veículos aguardando: agenda a próxima atualização
+    if (display_has_pending()) {
+        k_work_schedule_for_queue(&radar_output_q, &display_work,
+                                  K_MSEC(DISPLAY_UPDATE_INTERVAL_MS));
+    }
+}
+
+void radar_display_submit(const vehicle_data_t *vehicle)
+{
+    if (k_msgq_put(&display_queues[vehicle->lane], vehicle, K_NO_WAIT) == 0) {
+        k_work_schedule_for_queue(&radar_output_q, &display_work, K_NO_WAIT);
+    }
+}
+
+void radar_display_init(void)
+{
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        k_msgq_init(&display_queues[lane], display_queue_buffers[lane],
+                    sizeof(vehicle_data_t), MAX_VEHICLE_QUEUE_SIZE);
+    }
+}
+
+// Chamada após o início da fila de saída
+void radar_display_start(void)
+{
     display_dev = device_get_binding("DISPLAY_0");
     if (!display_dev) {
         printf("Display dummy não encontrado, usando console apenas\n");
     }
 
-    vehicle_data_t vehicle_data;
-    speed_status_t last_status = SPEED_NORMAL;
-    
-    while (1) {
-        // Verifica se há novos dados (não bloqueante)
-        if (k_msgq_get(&vehicle_data_queue, &vehicle_data, K_MSEC(100)) == 0) {
-            speed_status_t current_status = check_speed_status(vehicle_data.speed_kmh, 
-                                                             vehicle_data.type);
-            
-            // Atualiza display apenas se houve mudança
-            if (current_status != last_status || vehicle_data.speed_kmh > 0) {
-                update_display(vehicle_data.speed_kmh, vehicle_data.type, current_status);
-                last_status = current_status;
-            }
-        }
-        
-        k_sleep(K_MSEC(500));
+    // Atende veículos decididos antes de a fila de saída existir
+    if (display_has_pending()) {
+        k_work_schedule_for_queue(&radar_output_q, &display_work, K_NO_WAIT);
     }
 }
 
-K_THREAD_DEFINE(display_thread_id, 2048, display_thread, NULL, NULL, NULL, 4, 0, 0);
\ No newline at end of file
+void display_statistics(void)
+{
+    system_stats_t stats;
+
+    radar_stats_snapshot(&stats);
+
+    // Publicado periodicamente, fora do caminho de cada veículo
+    zbus_chan_pub(&system_stats_chan, &stats, K_NO_WAIT);
+
+    printf("[STATS] Total veiculos: %u, Leves: %u, Pesados: %u, Infracoes: %u\n",
+           stats.total_vehicles, stats.light_vehicles,
+           stats.heavy_vehicles, stats.infringements);
+}
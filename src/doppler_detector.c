@@ -0,0 +1,56 @@
+#include "radar.h"
+
+void doppler_detector_init(doppler_detector_t *det)
+{
+    memset(det, 0, sizeof(*det));
+}
+
+static void detector_to_vehicle(const doppler_detector_t *det, vehicle_data_t *vehicle)
+{
+    memset(vehicle, 0, sizeof(*vehicle));
+
+    // O radar não vê eixos: a velocidade vira o tempo equivalente entre os
+    // sensores, e o estágio de decisão a recalcula como faria para os laços
+    vehicle->time_between_sensors_us =
+        (uint32_t)(((uint64_t)SENSOR_DISTANCE_MM * 3600U * 100U) / MAX(det->best_speed_ckmh, 1U));
+    vehicle->time_between_sensors = vehicle->time_between_sensors_us / 1000U;
+    vehicle->total_passage_time = (det->blocks * DOPPLER_BLOCK_US) / 1000U;
+    vehicle->type = VEHICLE_UNKNOWN;
+    vehicle->direction = det->direction;
+    vehicle->valid_measurement = true;
+}
+
+// Recebe o pico de cada bloco (NULL se não houve alvo). Retorna true quando
+// um veículo saiu do feixe; a velocidade é a do bloco de maior potência,
+// próximo do eixo do feixe, onde o erro de cosseno é menor.
+bool doppler_detector_block(doppler_detector_t *det, const doppler_peak_t *peak,
+                            vehicle_data_t *vehicle)
+{
+    if (peak != NULL) {
+        if (!det->active) {
+            det->active = true;
+            det->blocks = 0;
+            det->best_power = 0;
+        }
+
+        det->missed_blocks = 0;
+        det->blocks++;
+
+        if (peak->power > det->best_power) {
+            det->best_power = peak->power;
+            det->best_speed_ckmh = peak->speed_ckmh;
+            det->direction = peak->bin_q8 >= 0 ? DIRECTION_FORWARD : DIRECTION_BACKWARD;
+        }
+        return false;
+    }
+
+    if (!det->active || ++det->missed_blocks < DOPPLER_HOLD_BLOCKS) {
+        return false;
+    }
+
+    detector_to_vehicle(det, vehicle);
+    det->active = false;
+    det->missed_blocks = 0;
+
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "radar.h"
+
+BUILD_ASSERT((DOPPLER_FFT_SIZE & (DOPPLER_FFT_SIZE - 1)) == 0,
+             "CONFIG_RADAR_DOPPLER_FFT_SIZE deve ser potência de 2");
+
+// Desvio Doppler em km/h por Hz, em centésimos: 1,8 * c / f0
+#define DOPPLER_CKMH_PER_HZ_NUM     539626ULL  // 1,8 * c / 1e6, x1000
+#define DOPPLER_CKMH_PER_HZ_DEN     (10ULL * DOPPLER_CARRIER_MHZ)
+
+// Raia da menor velocidade detectada
+#define DOPPLER_MIN_BIN \
+    MAX(1U, (uint32_t)(((uint64_t)CONFIG_RADAR_DOPPLER_MIN_SPEED_KMH * 100U * \
+                        DOPPLER_CKMH_PER_HZ_DEN * DOPPLER_FFT_SIZE) / \
+                       (DOPPLER_CKMH_PER_HZ_NUM * DOPPLER_SAMPLE_RATE_HZ)))
+
+// Janela de Hann e fatores de giro (cos, -sin) em q15. Calculados uma vez
+// em doppler_dsp_init(); o processamento de cada bloco é só em ponto fixo.
+static radar_q15_t hann_window[DOPPLER_FFT_SIZE];
+static radar_q15_t twiddles[DOPPLER_FFT_SIZE];
+static uint32_t spectrum[DOPPLER_FFT_SIZE];
+
+static inline radar_q15_t sat_q15(int32_t x)
+{
+    return (radar_q15_t)CLAMP(x, INT16_MIN, INT16_MAX);
+}
+
+static uint32_t isqrt32(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+void doppler_dsp_init(void)
+{
+    const float step = 2.0f * 3.14159265f / DOPPLER_FFT_SIZE;
+
+    for (int n = 0; n < DOPPLER_FFT_SIZE; n++) {
+        hann_window[n] = (radar_q15_t)(16383.5f * (1.0f - cosf(step * n)));
+    }
+
+    for (int k = 0; k < DOPPLER_FFT_SIZE / 2; k++) {
+        twiddles[2 * k] = sat_q15((int32_t)lrintf(32768.0f * cosf(step * k)));
+        twiddles[2 * k + 1] = sat_q15((int32_t)lrintf(-32768.0f * sinf(step * k)));
+    }
+}
+
+// Aplica a janela de Hann às amostras IQ intercaladas (I0, Q0, I1, Q1...)
+void doppler_window_q15(radar_q15_t *iq)
+{
+    for (int n = 0; n < DOPPLER_FFT_SIZE; n++) {
+        iq[2 * n] = (radar_q15_t)(((int32_t)iq[2 * n] * hann_window[n]) >> 15);
+        iq[2 * n + 1] = (radar_q15_t)(((int32_t)iq[2 * n + 1] * hann_window[n]) >> 15);
+    }
+}
+
+// FFT complexa radix-2 no próprio buffer, como arm_cfft_radix2_q15: cada
+// estágio divide por 2, e a saída fica escalada por 1/N sem saturar
+void doppler_cfft_q15(radar_q15_t *iq)
+{
+    const int n = DOPPLER_FFT_SIZE;
+
+    // Reordenação por bits invertidos
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j) {
+            radar_q15_t re = iq[2 * i];
+            radar_q15_t im = iq[2 * i + 1];
+
+            iq[2 * i] = iq[2 * j];
+            iq[2 * i + 1] = iq[2 * j + 1];
+            iq[2 * j] = re;
+            iq[2 * j + 1] = im;
+        }
+    }
+
+    for (int size = 2; size <= n; size <<= 1) {
+        int half = size >> 1;
+        int stride = n / size;
+
+        for (int start = 0; start < n; start += size) {
+            for (int k = 0; k < half; k++) {
+                radar_q15_t *a = &iq[2 * (start + k)];
+                radar_q15_t *b = &iq[2 * (start + k + half)];
+                int32_t wr = twiddles[2 * k * stride];
+                int32_t wi = twiddles[2 * k * stride + 1];
+                int32_t tr = ((int32_t)b[0] * wr - (int32_t)b[1] * wi) >> 15;
+                int32_t ti = ((int32_t)b[0] * wi + (int32_t)b[1] * wr) >> 15;
+                int32_t ar = a[0];
+                int32_t ai = a[1];
+
+                a[0] = sat_q15((ar + tr) >> 1);
+                a[1] = sat_q15((ai + ti) >> 1);
+                b[0] = sat_q15((ar - tr) >> 1);
+                b[1] = sat_q15((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+// Processa um bloco (destruindo as amostras) e devolve o pico, se houver
+// um veículo. Raias negativas são veículos se afastando do radar.
+bool doppler_estimate(radar_q15_t *iq, doppler_peak_t *peak)
+{
+    const int n = DOPPLER_FFT_SIZE;
+    uint64_t total = 0;
+    uint32_t best = 0;
+    int best_bin = 0;
+
+    doppler_window_q15(iq);
+    doppler_cfft_q15(iq);
+
+    // |X|^2 de cada raia (q15 * q15 cabe em 32 bits)
+    for (int k = 0; k < n; k++) {
+        int32_t re = iq[2 * k];
+        int32_t im = iq[2 * k + 1];
+
+        spectrum[k] = (uint32_t)(re * re) + (uint32_t)(im * im);
+        total += spectrum[k];
+    }
+
+    // Raias de ±DOPPLER_MIN_BIN até Nyquist; perto de DC ficam os objetos parados
+    for (int k = DOPPLER_MIN_BIN; k <= n - (int)DOPPLER_MIN_BIN; k++) {
+        if (spectrum[k] > best) {
+            best = spectrum[k];
+            best_bin = k;
+        }
+    }
+
+    if (best == 0 ||
+        (uint64_t)best * n <= total * CONFIG_RADAR_DOPPLER_DETECT_RATIO) {
+        return false;
+    }
+
+    // Interpolação do pico para a janela de Hann sobre as magnitudes vizinhas:
+    // delta = 2 * (|X[k+1]| - |X[k-1]|) / (|X[k-1]| + 2|X[k]| + |X[k+1]|)
+    int32_t left = isqrt32(spectrum[(best_bin + n - 1) % n]);
+    int32_t center = isqrt32(best);
+    int32_t right = isqrt32(spectrum[(best_bin + 1) % n]);
+    int32_t delta_q8 = (2 * 256 * (right - left)) / MAX(left + 2 * center + right, 1);
+    int32_t bin_q8 = (best_bin >= n / 2 ? best_bin - n : best_bin) * 256 + delta_q8;
+
+    uint64_t freq_q8_hz = ((uint64_t)abs(bin_q8) * DOPPLER_SAMPLE_RATE_HZ) / n;
+
+    peak->bin_q8 = bin_q8;
+    peak->speed_ckmh = (uint32_t)((freq_q8_hz * DOPPLER_CKMH_PER_HZ_NUM) /
+                                  (DOPPLER_CKMH_PER_HZ_DEN * 256U));
+    peak->power = best;
+
+    return true;
+}
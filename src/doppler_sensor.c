@@ -0,0 +1,182 @@
+#include "radar.h"
+
+#if defined(CONFIG_RADAR_DOPPLER)
+
+// Faixa monitorada pelo radar
+#define DOPPLER_LANE  0
+
+K_THREAD_STACK_DEFINE(doppler_q_stack, CONFIG_RADAR_DOPPLER_STACK_SIZE);
+static struct k_work_q doppler_q;
+
+// Blocos duplos: a aquisição enche um enquanto o outro é processado. O
+// produtor (ADC ou fonte sintética) é único, assim como o consumidor.
+static radar_q15_t doppler_blocks[2][2 * DOPPLER_FFT_SIZE];
+static uint8_t fill_block;
+static size_t fill_samples;
+static uint8_t ready_block;
+static atomic_t block_pending;
+
+static doppler_detector_t doppler_detector;
+
+static atomic_t blocks_processed;
+static atomic_t blocks_dropped;
+static atomic_t worst_block_us;
+
+static void doppler_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    uint32_t start = k_cycle_get_32();
+    doppler_peak_t peak;
+    vehicle_data_t vehicle_data;
+    bool found = doppler_estimate(doppler_blocks[ready_block], &peak);
+
+    // Bloco consumido: a aquisição pode usá-lo de novo
+    atomic_clear(&block_pending);
+
+    if (doppler_detector_block(&doppler_detector, found ? &peak : NULL, &vehicle_data)) {
+        vehicle_data.timestamp = k_uptime_get_32();
+        vehicle_data.release_time = vehicle_data.timestamp;
+        // Último bloco com o veículo, antes dos blocos de espera
+        vehicle_data.last_edge_time = vehicle_data.timestamp -
+                                      (DOPPLER_HOLD_BLOCKS * DOPPLER_FFT_SIZE * 1000U) /
+                                      DOPPLER_SAMPLE_RATE_HZ;
+        vehicle_data.lane = DOPPLER_LANE;
+
+        // Envia dados para o estágio de decisão da faixa
+        radar_pipeline_submit(&vehicle_data);
+    }
+
+    uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    atomic_val_t worst;
+
+    atomic_inc(&blocks_processed);
+
+    // Atualiza o pior caso observado
+    do {
+        worst = atomic_get(&worst_block_us);
+        if (elapsed_us <= (uint32_t)worst) {
+            break;
+        }
+    } while (!atomic_cas(&worst_block_us, worst, elapsed_us));
+}
+
+static K_WORK_DEFINE(doppler_work, doppler_work_handler);
+
+// Recebe amostras IQ intercaladas do ADC. Pode ser chamada a partir de
+// interrupções; retorna -EBUSY se o bloco anterior ainda não foi processado
+// (o bloco em aquisição é descartado).
+int radar_doppler_push(const radar_q15_t *iq, size_t samples)
+{
+    int ret = 0;
+
+    while (samples > 0) {
+        size_t count = MIN(samples, (size_t)DOPPLER_FFT_SIZE - fill_samples);
+
+        memcpy(&doppler_blocks[fill_block][2 * fill_samples], iq, count * 2 * sizeof(radar_q15_t));
+        fill_samples += count;
+        iq += 2 * count;
+        samples -= count;
+
+        if (fill_samples < DOPPLER_FFT_SIZE) {
+            break;
+        }
+
+        fill_samples = 0;
+
+        if (!atomic_cas(&block_pending, 0, 1)) {
+            atomic_inc(&blocks_dropped);
+            ret = -EBUSY;
+            continue;
+        }
+
+        ready_block = fill_block;
+        fill_block ^= 1;
+        k_work_submit_to_queue(&doppler_q, &doppler_work);
+    }
+
+    return ret;
+}
+
+#if defined(CONFIG_RADAR_DOPPLER_SYNTHETIC)
+// Veículos sintéticos, um por ciclo da fonte
+static const traffic_doppler_t synthetic_targets[] = {
+    { .speed_kmh = 45,  .beam_ms = 600, .amplitude = 8000, .noise = 2000 },
+    { .speed_kmh = 72,  .beam_ms = 400, .amplitude = 6000, .noise = 2000 },
+    { .speed_kmh = 95,  .beam_ms = 300, .amplitude = 8000, .noise = 2000 },
+    { .speed_kmh = 60,  .beam_ms = 500, .amplitude = 4000, .noise = 2000, .receding = true },
+    { .speed_kmh = 110, .beam_ms = 250, .amplitude = 8000, .noise = 2000 },
+};
+
+#define SYNTHETIC_PERIOD_MS  3000
+#define SYNTHETIC_CHUNK      32
+
+static traffic_iq_t synthetic_gen;
+static uint8_t synthetic_index;
+
+// Substitui o ADC: entrega um bloco de amostras. A geração usa ponto
+// flutuante, então roda na fila do Doppler e não na interrupção do timer.
+static void synthetic_work_handler(struct k_work *work)
+{
+    radar_q15_t chunk[2 * SYNTHETIC_CHUNK];
+
+    ARG_UNUSED(work);
+
+    if (synthetic_gen.sample * 1000ULL >= SYNTHETIC_PERIOD_MS * (uint64_t)DOPPLER_SAMPLE_RATE_HZ) {
+        synthetic_index = (synthetic_index + 1) % ARRAY_SIZE(synthetic_targets);
+        traffic_iq_init(&synthetic_gen, &synthetic_targets[synthetic_index]);
+    }
+
+    for (int n = 0; n < DOPPLER_FFT_SIZE; n += SYNTHETIC_CHUNK) {
+        traffic_iq_generate(&synthetic_gen, chunk, SYNTHETIC_CHUNK);
+        radar_doppler_push(chunk, SYNTHETIC_CHUNK);
+    }
+}
+
+static K_WORK_DEFINE(synthetic_work, synthetic_work_handler);
+
+// Um bloco por período de bloco
+static void synthetic_timer_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    k_work_submit_to_queue(&doppler_q, &synthetic_work);
+}
+
+static K_TIMER_DEFINE(synthetic_timer, synthetic_timer_expiry, NULL);
+#endif
+
+// Arma o radar Doppler na primeira fase do boot, no lugar dos sensores de laço
+int radar_doppler_init(void)
+{
+    const struct k_work_queue_config doppler_cfg = {
+        .name = "radar_doppler",
+    };
+
+    doppler_dsp_init();
+    doppler_detector_init(&doppler_detector);
+
+    // Processar um bloco é o estágio de sensores do radar Doppler
+    k_work_queue_init(&doppler_q);
+    k_work_queue_start(&doppler_q, doppler_q_stack,
+                       K_THREAD_STACK_SIZEOF(doppler_q_stack),
+                       RADAR_PRIO_SENSOR, &doppler_cfg);
+
+#if defined(CONFIG_RADAR_DOPPLER_SYNTHETIC)
+    traffic_iq_init(&synthetic_gen, &synthetic_targets[0]);
+    k_timer_start(&synthetic_timer, K_USEC(DOPPLER_BLOCK_US), K_USEC(DOPPLER_BLOCK_US));
+#endif
+
+    return 0;
+}
+
+void radar_doppler_report(void)
+{
+    uint32_t worst_us = atomic_get(&worst_block_us);
+
+    RADAR_INFO("[DOPPLER] Blocos: %u, descartados: %u, pior bloco: %u us (%u%% de %u us)",
+               (uint32_t)atomic_get(&blocks_processed), (uint32_t)atomic_get(&blocks_dropped),
+               worst_us, (worst_us * 100U) / DOPPLER_BLOCK_US, DOPPLER_BLOCK_US);
+}
+
+#endif /* CONFIG_RADAR_DOPPLER */
@@ -1,16 +1,58 @@
 #include "radar.h"
 
+static int sensor_arm_err;
+
+// Sequência de boot. Depois de um reset, os veículos só são vistos quando os
+// sensores estão armados, então eles vêm antes de qualquer outro serviço:
+//   1. threads de decisão e sensores de laço ou radar Doppler (radar_boot_arm,
+//      POST_KERNEL logo após o driver GPIO)
+//   2. fila de saída, display e câmera (radar_boot_output, APPLICATION)
+//   3. estado do sistema, configuração e medições de boot (main)
+#if defined(CONFIG_GPIO_INIT_PRIORITY)
+BUILD_ASSERT(CONFIG_RADAR_BOOT_ARM_INIT_PRIORITY > CONFIG_GPIO_INIT_PRIORITY,
+             "Os sensores devem ser armados depois do driver GPIO");
+#endif
+
+static int radar_boot_arm(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+
+    radar_pipeline_start_decision();
+
+#if defined(CONFIG_RADAR_DOPPLER)
+    sensor_arm_err = radar_doppler_init();
+#else
+    sensor_arm_err = sensor_interrupts_init();
+#endif
+    if (sensor_arm_err == 0) {
+        radar_boot_mark_armed();
+    }
+
+    return 0;
+}
+
+// Display e câmera dependem de drivers que podem iniciar depois dos sensores
+static int radar_boot_output(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+
+    radar_pipeline_start_output();
+
+    return 0;
+}
+
+SYS_INIT(radar_boot_arm, POST_KERNEL, CONFIG_RADAR_BOOT_ARM_INIT_PRIORITY);
+SYS_INIT(radar_boot_output, APPLICATION, 0);
+
 void main(void)
 {
     printf(COLOR_BLUE "\n=== Sistema Radar Eletronico Iniciado ===\n" COLOR_NORMAL);
-    printf("Distancia entre sensores: %d mm\n", SENSOR_DISTANCE_MM);
-    printf("Limite veiculos leves: %d km/h\n", SPEED_LIMIT_LIGHT);
-    printf("Limite veiculos pesados: %d km/h\n", SPEED_LIMIT_HEAVY);
-    printf("Limite de alerta: %d%%\n", WARNING_THRESHOLD);
-    printf("Taxa de falha da camera: %d%%\n\n", CAMERA_FAILURE_RATE);
-    
-    // Threads são iniciadas automaticamente pelo Zephyr
-    while (1) {
-        k_sleep(K_SECONDS(10));
+
+    if (sensor_arm_err != 0) {
+        handle_system_error("Controlador GPIO dos sensores indisponivel");
     }
-}
\ No newline at end of file
+
+    radar_system_init();
+    radar_print_configuration();
+    radar_boot_report();
+}
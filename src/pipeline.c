@@ -0,0 +1,177 @@
+#include "radar.h"
+
+// Pilhas: uma thread de decisão por faixa e uma fila de trabalho de saída
+K_THREAD_STACK_ARRAY_DEFINE(decision_stacks, RADAR_NUM_LANES, CONFIG_RADAR_DECISION_STACK_SIZE);
+K_THREAD_STACK_DEFINE(output_q_stack, CONFIG_RADAR_OUTPUT_STACK_SIZE);
+
+static struct k_thread decision_threads[RADAR_NUM_LANES];
+struct k_work_q radar_output_q;
+
+static const char *decision_names[] = {
+    "radar_decisao_0",
+    "radar_decisao_1",
+    "radar_decisao_2",
+    "radar_decisao_3",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(decision_names) >= RADAR_NUM_LANES,
+             "Faltam nomes em decision_names para CONFIG_RADAR_NUM_LANES");
+
+// Número de vezes que um estágio foi despachado por uma fila de trabalho,
+// por CPU. Despachos não são trocas de contexto: um despacho pode atender a
+// fila sem troca e uma troca pode não ter relação com o pipeline. As trocas
+// reais vêm do gancho de rastreamento do kernel (CONFIG_TRACING_USER).
+typedef struct {
+    atomic_t dispatches;
+    atomic_t switches;
+} __aligned(RADAR_CACHE_LINE_SIZE) dispatch_shard_t;
+
+static dispatch_shard_t dispatch_shards[RADAR_NUM_CPUS];
+
+static void report_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_handler);
+
+void radar_pipeline_count_dispatch(void)
+{
+    atomic_inc(&dispatch_shards[radar_cpu_id()].dispatches);
+}
+
+#if defined(CONFIG_TRACING_USER)
+// Chamado pelo escalonador a cada troca de contexto, com interrupções travadas
+void sys_trace_thread_switched_in_user(struct k_thread *thread)
+{
+    ARG_UNUSED(thread);
+
+    atomic_inc(&dispatch_shards[radar_cpu_id()].switches);
+}
+#endif
+
+#if defined(CONFIG_SCHED_CPU_MASK)
+// A máscara de CPU só pode ser alterada com a thread fora da fila de prontas
+static int decision_pin(k_tid_t tid, int cpu)
+{
+    int ret = k_thread_cpu_mask_clear(tid);
+
+    if (ret == 0) {
+        ret = k_thread_cpu_mask_enable(tid, cpu);
+    }
+
+    return ret;
+}
+#endif
+
+// Fixa a thread de decisão de cada faixa em uma das primeiras num_cpus CPUs.
+// No boot as threads ainda não foram iniciadas. Depois disso a máscara só
+// muda com a thread bloqueada na fila vazia da faixa: enquanto ela decide,
+// a troca é tentada de novo a cada 1 ms, sem suspender a thread.
+void radar_pipeline_pin_lanes(unsigned int num_cpus)
+{
+#if defined(CONFIG_SCHED_CPU_MASK)
+    num_cpus = CLAMP(num_cpus, 1U, (unsigned int)RADAR_NUM_CPUS);
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        while (decision_pin(&decision_threads[lane], lane % num_cpus) == -EINVAL) {
+            k_msleep(1);
+        }
+    }
+#else
+    ARG_UNUSED(num_cpus);
+#endif
+}
+
+void radar_pipeline_report(void)
+{
+    uint32_t vehicles = radar_deadline_completed(RADAR_STAGE_DECISION);
+    uint32_t dispatches = 0;
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        dispatches += atomic_get(&dispatch_shards[cpu].dispatches);
+    }
+
+    uint32_t per_vehicle_x100 = vehicles ? (dispatches * 100U) / vehicles : 0;
+
+    RADAR_INFO("[PIPELINE] Veiculos: %u, despachos: %u (%u.%02u por veiculo)",
+               vehicles, dispatches, per_vehicle_x100 / 100U, per_vehicle_x100 % 100U);
+
+#if defined(CONFIG_TRACING_USER)
+    uint32_t switches = 0;
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        switches += atomic_get(&dispatch_shards[cpu].switches);
+    }
+
+    per_vehicle_x100 = vehicles ? (uint32_t)(((uint64_t)switches * 100U) / vehicles) : 0;
+
+    // Todas as trocas do sistema, inclusive as da thread ociosa e de outras
+    // filas: com o radar parado, a contagem por veículo não tem significado
+    RADAR_INFO("[PIPELINE] Trocas de contexto: %u (%u.%02u por veiculo)",
+               switches, per_vehicle_x100 / 100U, per_vehicle_x100 % 100U);
+#endif
+
+#if defined(CONFIG_SCHED_THREAD_USAGE_ALL)
+    k_thread_runtime_stats_t rt_stats;
+
+    if (k_thread_runtime_stats_all_get(&rt_stats) == 0 && rt_stats.execution_cycles > 0) {
+        RADAR_INFO("[PIPELINE] CPU ociosa: %u%%",
+                   (uint32_t)((rt_stats.idle_cycles * 100U) / rt_stats.execution_cycles));
+    }
+#endif
+}
+
+static void report_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    radar_boot_report();
+    radar_deadline_report();
+    radar_pipeline_report();
+    radar_camera_report();
+#if defined(CONFIG_RADAR_DOPPLER)
+    radar_doppler_report();
+#endif
+    display_statistics();
+
+    k_work_schedule_for_queue(&radar_output_q, &report_work, K_SECONDS(10));
+}
+
+// Fase de boot 1: destino das interrupções dos sensores. Só inicializa filas
+// de mensagens e as threads de decisão, sem acessar dispositivos. As threads
+// são criadas paradas, fixadas em sua CPU e só então iniciadas.
+void radar_pipeline_start_decision(void)
+{
+    radar_decision_init();
+    radar_display_init();
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        k_thread_create(&decision_threads[lane], decision_stacks[lane],
+                        K_THREAD_STACK_SIZEOF(decision_stacks[lane]),
+                        radar_decision_thread, UINT_TO_POINTER(lane), NULL, NULL,
+                        RADAR_PRIO_DECISION, 0, K_FOREVER);
+        k_thread_name_set(&decision_threads[lane], decision_names[lane]);
+    }
+
+    radar_pipeline_pin_lanes(RADAR_NUM_CPUS);
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        k_thread_start(&decision_threads[lane]);
+    }
+}
+
+// Fase de boot 2, com os sensores já armados: display, câmera e relatório.
+// Veículos decididos antes disso aguardam nas filas e são atendidos aqui.
+void radar_pipeline_start_output(void)
+{
+    const struct k_work_queue_config output_cfg = {
+        .name = "radar_saida",
+    };
+
+    k_work_queue_init(&radar_output_q);
+    k_work_queue_start(&radar_output_q, output_q_stack,
+                       K_THREAD_STACK_SIZEOF(output_q_stack),
+                       RADAR_PRIO_OUTPUT, &output_cfg);
+
+    radar_display_start();
+    radar_camera_start();
+
+    k_work_schedule_for_queue(&radar_output_q, &report_work, K_SECONDS(10));
+}
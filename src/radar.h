@@ -21,20 +21,86 @@
 #define DISPLAY_UPDATE_INTERVAL_MS  CONFIG_RADAR_DISPLAY_UPDATE_INTERVAL_MS
 #define CAMERA_PROCESSING_TIME_MS   CONFIG_RADAR_CAMERA_PROCESSING_TIME_MS
 #define MAX_VEHICLE_QUEUE_SIZE      CONFIG_RADAR_MAX_VEHICLE_QUEUE_SIZE
+#define RADAR_NUM_LANES             CONFIG_RADAR_NUM_LANES
 #define AXLE_TIMEOUT_MS             CONFIG_RADAR_AXLE_TIMEOUT_MS
+#define SENSOR_MIN_PULSE_US         CONFIG_RADAR_SENSOR_MIN_PULSE_US
+#define MIN_AXLE_SPACING_MM         CONFIG_RADAR_MIN_AXLE_SPACING_MM
+#define MAX_AXLE_SPACING_MM         CONFIG_RADAR_MAX_AXLE_SPACING_MM
+#define MAX_SPEED_KMH               CONFIG_RADAR_MAX_SPEED_KMH
+#define MAX_TRACKS_PER_LANE         CONFIG_RADAR_MAX_TRACKS_PER_LANE
+#define DOPPLER_CARRIER_MHZ         CONFIG_RADAR_DOPPLER_CARRIER_MHZ
+#define DOPPLER_SAMPLE_RATE_HZ      CONFIG_RADAR_DOPPLER_SAMPLE_RATE_HZ
+#define DOPPLER_FFT_SIZE            CONFIG_RADAR_DOPPLER_FFT_SIZE
+#define DOPPLER_HOLD_BLOCKS         CONFIG_RADAR_DOPPLER_HOLD_BLOCKS
+
+// Menor tempo do primeiro eixo entre os sensores dentro do limite (us). A
+// velocidade passa do limite exatamente quando tempo * limite < distância *
+// 3600, ou seja, quando o tempo é menor que este valor (divisão arredondada
+// para cima).
+#define SPEED_LIMIT_TRANSIT_US(limit_kmh) \
+    ((uint32_t)(((uint64_t)SENSOR_DISTANCE_MM * 3600U + (limit_kmh) - 1U) / (limit_kmh)))
+
+// Idem para o limiar de alerta, WARNING_THRESHOLD % do limite
+#define SPEED_WARNING_TRANSIT_US(limit_kmh) \
+    ((uint32_t)(((uint64_t)SENSOR_DISTANCE_MM * 3600U * 100U + \
+                 (uint64_t)(limit_kmh) * WARNING_THRESHOLD - 1U) / \
+                ((uint64_t)(limit_kmh) * WARNING_THRESHOLD)))
+
+// Duração de um bloco de amostras do radar Doppler (us)
+#define DOPPLER_BLOCK_US \
+    ((uint32_t)(((uint64_t)DOPPLER_FFT_SIZE * 1000000U) / DOPPLER_SAMPLE_RATE_HZ))
 #define PLATE_VALIDATION_STRICT     CONFIG_RADAR_PLATE_VALIDATION_STRICT
 #define SPEED_CALIBRATION_FACTOR    (CONFIG_RADAR_SPEED_CALIBRATION_FACTOR / 100.0f)
 
+// Controlador GPIO dos sensores: alias radar-sensors no devicetree, ou gpio0
+#if DT_NODE_EXISTS(DT_ALIAS(radar_sensors))
+#define RADAR_SENSOR_GPIO_NODE      DT_ALIAS(radar_sensors)
+#else
+#define RADAR_SENSOR_GPIO_NODE      DT_NODELABEL(gpio0)
+#endif
+
+// Prazos relativos de cada estágio, medidos a partir do instante em que o
+// veículo está completo: última borda do sensor 2 mais o silêncio que encerra
+// o veículo no detector (release_time)
+#define DEADLINE_DECISION_MS        CONFIG_RADAR_DEADLINE_DECISION_MS
+#define DEADLINE_DISPLAY_MS         CONFIG_RADAR_DEADLINE_DISPLAY_MS
+#define DEADLINE_CAMERA_MS          CONFIG_RADAR_DEADLINE_CAMERA_MS
+
+// Pior caso da última borda até a decisão: o silêncio de encerramento,
+// MIN(MAX_AXLE_SPACING_MM / velocidade, AXLE_TIMEOUT_MS), mais o prazo da
+// decisão. Contado à parte para que a espera não fique oculta em release_time.
+#define DEADLINE_EDGE_DECISION_MS   (AXLE_TIMEOUT_MS + DEADLINE_DECISION_MS)
+
+// Prioridades derivadas dos prazos (deadline monotonic): a posição de um
+// estágio é o número de estágios com prazo estritamente menor que o seu
+#define RADAR_DEADLINE_RANK(d) \
+    ((DEADLINE_DECISION_MS < (d)) + (DEADLINE_DISPLAY_MS < (d)) + (DEADLINE_CAMERA_MS < (d)))
+
+#define RADAR_PRIO_SENSOR           CONFIG_RADAR_THREAD_PRIORITY_BASE
+#define RADAR_PRIO_DECISION         (RADAR_PRIO_SENSOR + 1 + RADAR_DEADLINE_RANK(DEADLINE_DECISION_MS))
+#define RADAR_PRIO_DISPLAY          (RADAR_PRIO_SENSOR + 1 + RADAR_DEADLINE_RANK(DEADLINE_DISPLAY_MS))
+#define RADAR_PRIO_CAMERA           (RADAR_PRIO_SENSOR + 1 + RADAR_DEADLINE_RANK(DEADLINE_CAMERA_MS))
+
+// Display e câmera compartilham a fila de saída, que herda o menor dos prazos
+#define RADAR_PRIO_OUTPUT           MIN(RADAR_PRIO_DISPLAY, RADAR_PRIO_CAMERA)
+
 // Configurações de classificação
 #if defined(CONFIG_RADAR_CLASSIFICATION_AXLE_COUNT)
 #define CLASSIFICATION_BY_AXLE_COUNT 1
 #define CLASSIFICATION_BY_TIME 0
+#define CLASSIFICATION_BY_MODEL 0
 #elif defined(CONFIG_RADAR_CLASSIFICATION_TIME_BASED)
 #define CLASSIFICATION_BY_AXLE_COUNT 0
 #define CLASSIFICATION_BY_TIME 1
+#define CLASSIFICATION_BY_MODEL 0
+#elif defined(CONFIG_RADAR_CLASSIFICATION_MODEL)
+#define CLASSIFICATION_BY_AXLE_COUNT 0
+#define CLASSIFICATION_BY_TIME 0
+#define CLASSIFICATION_BY_MODEL 1
 #else
 #define CLASSIFICATION_BY_AXLE_COUNT 1
 #define CLASSIFICATION_BY_TIME 0
+#define CLASSIFICATION_BY_MODEL 0
 #endif
 
 // Configurações de debug
@@ -79,11 +145,18 @@
 // GPIO dos sensores
 #define SENSOR_1_PIN         5
 #define SENSOR_2_PIN         6
+#define SENSOR_1_PIN_LANE(l) (SENSOR_1_PIN + 2 * (l))
+#define SENSOR_2_PIN_LANE(l) (SENSOR_2_PIN + 2 * (l))
+
+// SMP: dados escritos por CPU ficam em linhas de cache separadas
+#define RADAR_NUM_CPUS          CONFIG_MP_NUM_CPUS
+#define RADAR_CACHE_LINE_SIZE   64
 
 // Constantes de conversão
 #define MS_TO_HOURS          3.6e6f    // 1 hora = 3.600.000 ms
 #define MM_TO_KM             1e-6f     // 1 mm = 0.000001 km
 #define MIN_TIME_BETWEEN_SENSORS 10    // Tempo mínimo válido entre sensores (ms)
+#define RADAR_MAX_AXLES          10    // Mesmo limite de is_valid_axle_count()
 
 // Cores ANSI
 #define COLOR_NORMAL         "\033[0m"
@@ -164,18 +237,135 @@ typedef enum {
     DIRECTION_BACKWARD   // Sensor2 -> Sensor1
 } direction_t;
 
+// Estágios do pipeline com prazo monitorado
+typedef enum {
+    RADAR_STAGE_DECISION = 0,
+    RADAR_STAGE_DISPLAY,
+    RADAR_STAGE_CAMERA,
+    RADAR_STAGE_EDGE_DECISION,  // Última borda -> decisão, inclui o encerramento
+    RADAR_STAGE_COUNT
+} radar_stage_t;
+
+// Resultado de uma borda no detector de eixos
+typedef enum {
+    AXLE_EDGE_IGNORED = 0,  // Repique ou borda sem veículo
+    AXLE_EDGE_ACCEPTED,
+    AXLE_EDGE_SPEEDING,     // Infração prevista: primeiro eixo no sensor 2 ou classe estimada
+    AXLE_EDGE_CLEARED       // Previsão desfeita pela classe estimada no sensor 1
+} axle_edge_t;
+
+// Motivo da liberação dos quadros presos por um pré-disparo
+typedef enum {
+    CAMERA_RELEASE_EDGE = 0,  // Previsão desfeita na borda pela classe estimada
+    CAMERA_RELEASE_DECISION,  // Infração não confirmada pela decisão
+    CAMERA_RELEASE_DROPPED,   // Veículo descartado ou captura não enfileirada
+    CAMERA_RELEASE_COUNT
+} camera_release_t;
+
+// Sensores de laço de uma faixa
+typedef enum {
+    RADAR_SENSOR_1 = 0,  // Contagem de eixos
+    RADAR_SENSOR_2       // Velocidade
+} radar_sensor_t;
+
 // Estrutura de dados do veículo
 typedef struct {
-    uint32_t timestamp;
+    uint32_t timestamp;        // Primeira borda do veículo (ms de uptime)
+    uint32_t release_time;     // Veículo completo, origem dos prazos (ms de uptime)
     uint32_t time_between_sensors;
+    uint32_t time_between_sensors_us;  // Resolução fina; 0 se não medido
     vehicle_type_t type;
     float speed_kmh;
     uint8_t axle_count;
     direction_t direction;
     uint32_t total_passage_time;
     bool valid_measurement;
+    uint8_t lane;
+    uint16_t axle_spacing_mm[RADAR_MAX_AXLES - 1];  // Medidas no sensor 1; 0 além do último eixo
+    uint16_t length_mm;        // Primeiro ao último eixo
+    uint32_t sensor2_us;       // Primeiro eixo no sensor 2 (us); 0 se não medido
+    bool infraction_predicted; // Infração prevista na borda; câmera pré-armada
+    uint32_t ready_us;         // Detector pôde encerrar o veículo (us)
+    uint32_t last_edge_us;     // Última borda do veículo (us)
+    uint32_t last_edge_time;   // Última borda do veículo (ms de uptime); 0 se não medido
 } vehicle_data_t;
 
+// Veículo em passagem por uma faixa (tempos em us)
+typedef struct {
+    uint8_t sensor1_axles;
+    uint8_t sensor2_axles;
+    uint32_t sensor1_us[RADAR_MAX_AXLES];  // Borda de cada eixo no sensor 1
+    uint32_t last_sensor1_us;
+    uint32_t last_sensor2_us;
+    uint32_t transit_us;       // Primeiro eixo entre os sensores; 0 até medir
+    bool infraction_predicted;
+} axle_track_t;
+
+// Detector de eixos de uma faixa: fila circular de veículos em passagem,
+// do mais antigo (head) para o mais recente
+typedef struct {
+    axle_track_t tracks[MAX_TRACKS_PER_LANE];
+    uint8_t head;
+    uint8_t count;
+    uint32_t last_sensor2_us;  // Última borda aceita no sensor 2 (debounce)
+    uint32_t dropped_tracks;   // Veículos abandonados ou descartados por falta de espaço
+    uint32_t dropped_predictions;  // Descartados com a câmera pré-armada, ainda não liberados
+} axle_detector_t;
+
+// Veículo sintético para o gerador de tráfego
+typedef struct {
+    uint32_t speed_kmh;
+    uint8_t axle_count;
+    uint16_t axle_spacing_mm[RADAR_MAX_AXLES - 1];
+    uint32_t bounce_us;        // Repique após cada borda; 0 = sem repique
+} traffic_vehicle_t;
+
+// Amostras em ponto fixo Q15, com prefixo para não colidir com o radar_q15_t do
+// CMSIS-DSP
+typedef int16_t radar_q15_t;
+
+// Pico do espectro de um bloco do radar Doppler
+typedef struct {
+    int32_t bin_q8;            // Raia interpolada (1/256); negativa = afastando
+    uint32_t speed_ckmh;       // Velocidade em centésimos de km/h
+    uint32_t power;            // Potência do pico (|X|^2)
+} doppler_peak_t;
+
+// Segmentação dos blocos do radar Doppler em veículos
+typedef struct {
+    bool active;
+    uint8_t missed_blocks;
+    uint16_t blocks;
+    uint32_t best_power;
+    uint32_t best_speed_ckmh;
+    direction_t direction;
+} doppler_detector_t;
+
+// Veículo sintético no feixe do radar Doppler
+typedef struct {
+    uint32_t speed_kmh;
+    uint32_t beam_ms;          // Tempo do veículo no feixe
+    int16_t amplitude;         // Amplitude do eco (q15)
+    int16_t noise;             // Amplitude do ruído uniforme (q15)
+    bool receding;
+} traffic_doppler_t;
+
+// Estado do gerador de amostras IQ
+typedef struct {
+    traffic_doppler_t target;
+    uint32_t phase;
+    uint32_t phase_step;
+    uint32_t sample;
+    uint32_t beam_samples;
+    uint32_t noise_state;
+} traffic_iq_t;
+
+// Borda de sensor produzida pelo gerador de tráfego
+typedef struct {
+    uint32_t time_us;
+    radar_sensor_t sensor;
+} sensor_edge_t;
+
 // Estrutura de dados da câmera
 typedef struct {
     char plate[8]; // AAA1A23 ou AAA1234 + null terminator
@@ -202,48 +392,12 @@ ZBUS_CHAN_DECLARE(camera_result_chan);
 ZBUS_CHAN_DECLARE(system_status_chan);
 ZBUS_CHAN_DECLARE(system_stats_chan);
 
-// Estruturas ZBUS
-ZBUS_CHAN_DEFINE(camera_trigger_chan,     /* Name */
-                 vehicle_data_t,          /* Message type */
-                 NULL,                    /* Validator */
-                 NULL,                    /* User data */
-                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
-                 ZBUS_MSG_INIT({0})       /* Initial value */
-);
-
-ZBUS_CHAN_DEFINE(camera_result_chan,      /* Name */
-                 camera_data_t,           /* Message type */
-                 NULL,                    /* Validator */
-                 NULL,                    /* User data */
-                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
-                 ZBUS_MSG_INIT({0})       /* Initial value */
-);
-
-ZBUS_CHAN_DEFINE(system_status_chan,      /* Name */
-                 system_status_t,         /* Message type */
-                 NULL,                    /* Validator */
-                 NULL,                    /* User data */
-                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
-                 ZBUS_MSG_INIT(SYSTEM_INIT) /* Initial value */
-);
-
-ZBUS_CHAN_DEFINE(system_stats_chan,       /* Name */
-                 system_stats_t,          /* Message type */
-                 NULL,                    /* Validator */
-                 NULL,                    /* User data */
-                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
-                 ZBUS_MSG_INIT({0})       /* Initial value */
-);
-
-// Filas de mensagens
-extern struct k_msgq vehicle_data_queue;
-
-// Semáforos e mutexes
-extern struct k_sem sensor_sem;
-extern struct k_mutex stats_mutex;
+// Fila de trabalho de saída do pipeline (display e câmera); a decisão roda
+// em uma thread por faixa
+extern struct k_work_q radar_output_q;
 
-// Estatísticas globais do sistema
-extern system_stats_t global_stats;
+// Semáforos
+extern struct k_sem sensor_sem;
 
 // Protótipos de funções públicas
 
@@ -251,18 +405,84 @@ extern system_stats_t global_stats;
 void radar_system_init(void);
 void radar_print_configuration(void);
 
+// Funções de medição do boot
+void radar_boot_mark_armed(void);
+void radar_boot_mark_vehicle(void);
+uint32_t radar_boot_armed_us(void);
+uint32_t radar_boot_first_vehicle_us(void);
+void radar_boot_report(void);
+
 // Funções de sensores
-void sensor_interrupts_init(void);
+int sensor_interrupts_init(void);
 void simulate_sensor_events(void);
 bool validate_vehicle_data(const vehicle_data_t *data);
 
+// Funções do detector de eixos
+void axle_detector_init(axle_detector_t *det);
+axle_edge_t axle_detector_edge(axle_detector_t *det, radar_sensor_t sensor, uint32_t time_us);
+bool axle_detector_poll(axle_detector_t *det, uint32_t now_us, vehicle_data_t *vehicle);
+uint32_t axle_detector_poll_delay_us(const axle_detector_t *det, uint32_t now_us);
+uint32_t axle_detector_take_dropped_predictions(axle_detector_t *det);
+uint32_t axle_debounce_window_us(uint32_t transit_us);
+
+// Funções do gerador de tráfego (tests/traffic_generator.c, só nos testes)
+size_t traffic_generate_edges(const traffic_vehicle_t *vehicle, uint32_t start_us,
+                              sensor_edge_t *edges, size_t max_edges);
+size_t traffic_generate_stream(const traffic_vehicle_t *vehicles, size_t vehicle_count,
+                               uint32_t gap_mm, uint32_t start_us,
+                               sensor_edge_t *edges, size_t max_edges);
+void traffic_iq_init(traffic_iq_t *gen, const traffic_doppler_t *target);
+void traffic_iq_generate(traffic_iq_t *gen, radar_q15_t *iq, size_t samples);
+
+// Funções do radar Doppler
+void doppler_dsp_init(void);
+void doppler_window_q15(radar_q15_t *iq);
+void doppler_cfft_q15(radar_q15_t *iq);
+bool doppler_estimate(radar_q15_t *iq, doppler_peak_t *peak);
+void doppler_detector_init(doppler_detector_t *det);
+bool doppler_detector_block(doppler_detector_t *det, const doppler_peak_t *peak,
+                            vehicle_data_t *vehicle);
+int radar_doppler_init(void);
+int radar_doppler_push(const radar_q15_t *iq, size_t samples);
+void radar_doppler_report(void);
+
 // Funções de cálculo e classificação
 void calculate_speed(vehicle_data_t *vehicle);
 speed_status_t check_speed_status(float speed, vehicle_type_t type);
+bool speed_transit_exceeds_limit(uint32_t transit_us, vehicle_type_t type);
+speed_status_t check_transit_status(uint32_t transit_us, vehicle_type_t type);
+speed_status_t vehicle_speed_status(const vehicle_data_t *vehicle);
 vehicle_type_t classify_vehicle(const vehicle_data_t *data);
+vehicle_type_t classify_vehicle_axle_count(const vehicle_data_t *data);
+vehicle_type_t classify_vehicle_model(const vehicle_data_t *data);
+vehicle_type_t classify_vehicle_partial(uint8_t axle_count, const uint16_t *spacing_mm,
+                                        uint32_t transit_us);
+vehicle_type_t classify_vehicle_partial_model(uint8_t axle_count, const uint16_t *spacing_mm,
+                                              uint32_t transit_us);
 direction_t determine_direction(uint32_t sensor1_time, uint32_t sensor2_time);
 
+// Funções do pipeline
+void radar_pipeline_start_decision(void);
+void radar_pipeline_start_output(void);
+void radar_decision_init(void);
+void radar_decision_thread(void *p1, void *p2, void *p3);
+int radar_pipeline_submit(const vehicle_data_t *vehicle);
+void radar_pipeline_pin_lanes(unsigned int num_cpus);
+void radar_display_submit(const vehicle_data_t *vehicle);
+void radar_pipeline_count_dispatch(void);
+void radar_pipeline_report(void);
+
+// Funções de monitoramento de prazos
+void radar_deadline_begin(radar_stage_t stage, uint32_t release_time);
+bool radar_deadline_end(radar_stage_t stage, uint32_t release_time);
+uint32_t radar_deadline_misses(radar_stage_t stage);
+uint32_t radar_deadline_completed(radar_stage_t stage);
+uint32_t radar_deadline_worst_ms(radar_stage_t stage);
+void radar_deadline_report(void);
+
 // Funções de display
+void radar_display_init(void);
+void radar_display_start(void);
 void update_display(float speed, vehicle_type_t type, speed_status_t status);
 void display_system_status(system_status_t status);
 void display_statistics(void);
@@ -272,11 +492,22 @@ void clear_display(void);
 bool validate_license_plate(const char *plate);
 void simulate_license_plate(char *plate, bool *valid);
 void camera_capture_plate(const vehicle_data_t *vehicle_data);
+void radar_camera_start(void);
+void radar_camera_prearm(uint8_t lane, uint32_t edge_us);
+void radar_camera_release(uint8_t lane, camera_release_t reason);
+uint32_t radar_camera_prearm_count(void);
+uint32_t radar_camera_released_count(camera_release_t reason);
+uint32_t radar_camera_prearm_worst_us(void);
+uint32_t radar_camera_trigger_worst_us(void);
+void radar_camera_report(void);
 
 // Funções de utilidade
 uint32_t get_current_timestamp(void);
+uint32_t radar_now_us(void);
+uint32_t radar_us_to_uptime_ms(uint32_t time_us);
 void update_system_stats(vehicle_type_t type, bool infringement, bool camera_fail);
 void reset_system_stats(void);
+void radar_stats_snapshot(system_stats_t *stats);
 float apply_calibration_factor(float speed);
 
 // Funções de debug
@@ -289,6 +520,17 @@ void print_camera_data(const camera_data_t *data);
 void test_calculate_speed(void);
 void test_classify_vehicle(void);
 void test_validate_license_plate(void);
+void test_deadline_suite(void);
+void test_lane_scaling_suite(void);
+void test_axle_detector_suite(void);
+void test_multi_vehicle_suite(void);
+void test_doppler_suite(void);
+void test_vehicle_classifier_suite(void);
+void test_infraction_prediction_suite(void);
+
+// Gancho chamado pela decisão a cada veículo (carga sintética dos benchmarks)
+typedef void (*radar_decision_hook_t)(const vehicle_data_t *vehicle);
+void radar_decision_set_test_hook(radar_decision_hook_t hook);
 #endif
 
 // Funções de tratamento de erro
@@ -315,6 +557,20 @@ static const char *DIRECTION_STR[] = {
 };
 
 // Inline functions para melhor performance
+
+// CPU atual, usada só para escolher o shard de um contador atômico. Em
+// contexto preemptível a thread pode migrar logo após a leitura; o índice
+// desatualizado só faz o incremento cair no shard de outra CPU, o que
+// mantém os totais corretos e custa apenas a localidade de cache. As filas
+// de decisão são fixadas em uma CPU, então ali o índice não muda.
+static inline unsigned int radar_cpu_id(void) {
+#if defined(CONFIG_SMP)
+    return arch_curr_cpu()->id;
+#else
+    return 0;
+#endif
+}
+
 static inline bool is_valid_speed(float speed) {
     return (speed >= 1.0f && speed <= 300.0f); // 1-300 km/h
 }
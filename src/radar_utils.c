@@ -1,18 +1,63 @@
 #include "radar.h"
 
 // Variáveis globais
-system_stats_t global_stats = {0};
 struct k_sem sensor_sem;
-struct k_mutex stats_mutex;
+
+// Estatísticas por CPU: cada thread de decisão fica fixa em uma CPU e só
+// incrementa o próprio bloco, sem mutex no caminho de cada veículo
+typedef struct {
+    atomic_t total_vehicles;
+    atomic_t light_vehicles;
+    atomic_t heavy_vehicles;
+    atomic_t infringements;
+    atomic_t camera_failures;
+    atomic_t system_errors;
+} __aligned(RADAR_CACHE_LINE_SIZE) radar_stats_shard_t;
+
+static radar_stats_shard_t stats_shards[RADAR_NUM_CPUS];
+
+// Canais ZBUS
+ZBUS_OBS_DECLARE(camera_listener);
+
+ZBUS_CHAN_DEFINE(camera_trigger_chan,     /* Name */
+                 vehicle_data_t,          /* Message type */
+                 NULL,                    /* Validator */
+                 NULL,                    /* User data */
+                 ZBUS_OBSERVERS(camera_listener), /* Observers */
+                 ZBUS_MSG_INIT({0})       /* Initial value */
+);
+
+ZBUS_CHAN_DEFINE(camera_result_chan,      /* Name */
+                 camera_data_t,           /* Message type */
+                 NULL,                    /* Validator */
+                 NULL,                    /* User data */
+                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
+                 ZBUS_MSG_INIT({0})       /* Initial value */
+);
+
+ZBUS_CHAN_DEFINE(system_status_chan,      /* Name */
+                 system_status_t,         /* Message type */
+                 NULL,                    /* Validator */
+                 NULL,                    /* User data */
+                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
+                 ZBUS_MSG_INIT(SYSTEM_INIT) /* Initial value */
+);
+
+ZBUS_CHAN_DEFINE(system_stats_chan,       /* Name */
+                 system_stats_t,          /* Message type */
+                 NULL,                    /* Validator */
+                 NULL,                    /* User data */
+                 ZBUS_OBSERVERS_EMPTY,    /* Observers */
+                 ZBUS_MSG_INIT({0})       /* Initial value */
+);
 
 void radar_system_init(void)
 {
-    // Inicializa semáforos e mutexes
+    // Inicializa semáforos
     k_sem_init(&sensor_sem, 1, 1);
-    k_mutex_init(&stats_mutex);
     
-    // Reseta estatísticas
-    reset_system_stats();
+    // As estatísticas não são zeradas aqui: os sensores já estão armados e
+    // podem ter contado veículos (os blocos partem zerados da .bss)
     
     // Publica status inicial
     system_status_t status = SYSTEM_READY;
@@ -30,45 +75,72 @@ void radar_print_configuration(void)
     RADAR_INFO("Limite de alerta: %d%%", WARNING_THRESHOLD);
     RADAR_INFO("Taxa de falha da camera: %d%%", CAMERA_FAILURE_RATE);
     RADAR_INFO("Tempo de debounce: %d ms", DEBOUNCE_TIME_MS);
-    RADAR_INFO("Fator de calibracao: %.2f", SPEED_CALIBRATION_FACTOR);
-    RADAR_INFO("Classificacao por: %s", 
+    RADAR_INFO("Fator de calibracao: %d.%02d",
+               CONFIG_RADAR_SPEED_CALIBRATION_FACTOR / 100,
+               CONFIG_RADAR_SPEED_CALIBRATION_FACTOR % 100);
+    RADAR_INFO("Classificacao por: %s",
+               CLASSIFICATION_BY_MODEL ? "MODELO (ARVORE DE DECISAO)" :
                CLASSIFICATION_BY_AXLE_COUNT ? "CONTAGEM DE EIXOS" : "TEMPO ENTRE EIXOS");
     RADAR_INFO("Validacao rigorosa: %s", PLATE_VALIDATION_STRICT ? "SIM" : "NAO");
     RADAR_INFO("Modo debug: %s", RADAR_DEBUG ? "ATIVADO" : "DESATIVADO");
     RADAR_INFO("Simulacao: %s", SENSOR_SIMULATION ? "ATIVADA" : "DESATIVADA");
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        RADAR_INFO("Faixa %u: sensores GPIO %d (eixos) e GPIO %d (velocidade)",
+                   lane, SENSOR_1_PIN_LANE(lane), SENSOR_2_PIN_LANE(lane));
+    }
 }
 
 void update_system_stats(vehicle_type_t type, bool infringement, bool camera_fail)
 {
-    k_mutex_lock(&stats_mutex, K_FOREVER);
-    
-    global_stats.total_vehicles++;
+    radar_stats_shard_t *shard = &stats_shards[radar_cpu_id()];
+
+    atomic_inc(&shard->total_vehicles);
     
     if (type == VEHICLE_LIGHT) {
-        global_stats.light_vehicles++;
+        atomic_inc(&shard->light_vehicles);
     } else if (type == VEHICLE_HEAVY) {
-        global_stats.heavy_vehicles++;
+        atomic_inc(&shard->heavy_vehicles);
     }
     
     if (infringement) {
-        global_stats.infringements++;
+        atomic_inc(&shard->infringements);
     }
     
     if (camera_fail) {
-        global_stats.camera_failures++;
+        atomic_inc(&shard->camera_failures);
+    }
+}
+
+// Soma os blocos de todas as CPUs; usada fora do caminho de cada veículo
+void radar_stats_snapshot(system_stats_t *stats)
+{
+    memset(stats, 0, sizeof(system_stats_t));
+
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        radar_stats_shard_t *shard = &stats_shards[cpu];
+
+        stats->total_vehicles += atomic_get(&shard->total_vehicles);
+        stats->light_vehicles += atomic_get(&shard->light_vehicles);
+        stats->heavy_vehicles += atomic_get(&shard->heavy_vehicles);
+        stats->infringements += atomic_get(&shard->infringements);
+        stats->camera_failures += atomic_get(&shard->camera_failures);
+        stats->system_errors += atomic_get(&shard->system_errors);
     }
-    
-    // Publica estatísticas atualizadas
-    zbus_chan_pub(&system_stats_chan, &global_stats, K_NO_WAIT);
-    
-    k_mutex_unlock(&stats_mutex);
 }
 
 void reset_system_stats(void)
 {
-    k_mutex_lock(&stats_mutex, K_FOREVER);
-    memset(&global_stats, 0, sizeof(system_stats_t));
-    k_mutex_unlock(&stats_mutex);
+    for (int cpu = 0; cpu < RADAR_NUM_CPUS; cpu++) {
+        radar_stats_shard_t *shard = &stats_shards[cpu];
+
+        atomic_clear(&shard->total_vehicles);
+        atomic_clear(&shard->light_vehicles);
+        atomic_clear(&shard->heavy_vehicles);
+        atomic_clear(&shard->infringements);
+        atomic_clear(&shard->camera_failures);
+        atomic_clear(&shard->system_errors);
+    }
 }
 
 uint32_t get_current_timestamp(void)
@@ -76,6 +148,62 @@ uint32_t get_current_timestamp(void)
     return k_uptime_get_32();
 }
 
+// Relógio dos sensores: contador de ciclos do hardware, com resolução de um
+// ciclo e independente da taxa de ticks do kernel. k_cycle_get_32() estoura
+// antes dos us de 32 bits (171 s a 25 MHz), então os ciclos são acumulados
+// em 64 bits; o timer abaixo garante uma leitura por período de estouro.
+static struct k_spinlock clock_lock;
+static uint32_t clock_last_cycles;
+static uint64_t clock_cycles;
+
+uint32_t radar_now_us(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&clock_lock);
+    uint32_t now = k_cycle_get_32();
+    uint64_t cycles;
+
+    clock_cycles += now - clock_last_cycles;
+    clock_last_cycles = now;
+    cycles = clock_cycles;
+
+    k_spin_unlock(&clock_lock, key);
+
+    return (uint32_t)k_cyc_to_us_floor64(cycles);
+}
+
+static void clock_keepalive(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    (void)radar_now_us();
+}
+
+static K_TIMER_DEFINE(clock_timer, clock_keepalive, NULL);
+
+// Antes de radar_boot_arm: a primeira borda já encontra o relógio em uso
+static int radar_clock_init(const struct device *dev)
+{
+    uint32_t period_ms = k_cyc_to_ms_floor32(UINT32_MAX) / 2U;
+
+    ARG_UNUSED(dev);
+
+    k_timer_start(&clock_timer, K_MSEC(period_ms), K_MSEC(period_ms));
+
+    return 0;
+}
+
+SYS_INIT(radar_clock_init, POST_KERNEL, 0);
+
+// Converte um instante recente de radar_now_us() para a base de
+// k_uptime_get_32(). A diferença é sem sinal, válida através do estouro
+// de 32 bits dos us.
+uint32_t radar_us_to_uptime_ms(uint32_t time_us)
+{
+    uint32_t now_ms = k_uptime_get_32();
+
+    return now_ms - (radar_now_us() - time_us) / 1000U;
+}
+
 float apply_calibration_factor(float speed)
 {
     return speed * SPEED_CALIBRATION_FACTOR;
@@ -85,9 +213,7 @@ void handle_system_error(const char *error_message)
 {
     RADAR_ERR("Erro do sistema: %s", error_message);
     
-    k_mutex_lock(&stats_mutex, K_FOREVER);
-    global_stats.system_errors++;
-    k_mutex_unlock(&stats_mutex);
+    atomic_inc(&stats_shards[radar_cpu_id()].system_errors);
     
     // Publica status de erro
     system_status_t status = SYSTEM_ERROR;
@@ -1,93 +1,137 @@
 #include "radar.h"
 
-static const struct device *gpio_dev;
-static struct gpio_callback sensor1_cb, sensor2_cb;
-
-// Variáveis para máquina de estados
-static volatile uint32_t sensor1_time = 0;
-static volatile uint32_t sensor2_time = 0;
-static volatile uint8_t axle_count = 0;
-static volatile uint32_t last_axle_time = 0;
-static volatile bool sensor1_triggered = false;
-
-// Interrupção do Sensor 1 (contagem de eixos)
-void sensor1_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+// Controlador dos sensores resolvido em tempo de compilação pelo devicetree
+static const struct device *const gpio_dev = DEVICE_DT_GET_OR_NULL(RADAR_SENSOR_GPIO_NODE);
+static struct gpio_callback sensor_cb;
+
+// Detector de eixos de cada faixa. O lock é por faixa: serializa a
+// interrupção do GPIO e a do timer de encerramento da mesma faixa
+static axle_detector_t lane_detectors[RADAR_NUM_LANES];
+static struct k_spinlock lane_locks[RADAR_NUM_LANES];
+static struct k_timer lane_timers[RADAR_NUM_LANES];
+
+// Envia os veículos encerrados e reagenda a verificação. Chamada com o lock da faixa
+static void sensor_lane_poll(uint8_t lane, uint32_t now_us)
 {
-    uint32_t current_time = k_uptime_get_32();
-    
-    // Filtro de bouncing (mínimo 50ms entre pulsos)
-    if ((current_time - last_axle_time) > 50) {
-        axle_count++;
-        last_axle_time = current_time;
+    vehicle_data_t vehicle_data;
+
+    while (axle_detector_poll(&lane_detectors[lane], now_us, &vehicle_data)) {
+        // Tempos das bordas, não do encerramento: atrasos do timer e da
+        // interrupção contam contra os prazos dos estágios
+        vehicle_data.timestamp = radar_us_to_uptime_ms(vehicle_data.sensor2_us -
+                                                       vehicle_data.time_between_sensors_us);
+        vehicle_data.release_time = radar_us_to_uptime_ms(vehicle_data.ready_us);
+        vehicle_data.last_edge_time = radar_us_to_uptime_ms(vehicle_data.last_edge_us);
+        vehicle_data.lane = lane;
+
+        // Envia dados para o estágio de decisão da faixa
+        radar_pipeline_submit(&vehicle_data);
+    }
+
+    // Veículos descartados nunca chegam à decisão, que liberaria a câmera
+    for (uint32_t n = axle_detector_take_dropped_predictions(&lane_detectors[lane]); n > 0; n--) {
+        radar_camera_release(lane, CAMERA_RELEASE_DROPPED);
+    }
+
+    uint32_t delay_us = axle_detector_poll_delay_us(&lane_detectors[lane], now_us);
+
+    if (delay_us > 0) {
+        k_timer_start(&lane_timers[lane], K_USEC(delay_us), K_NO_WAIT);
     }
-    
-    sensor1_triggered = true;
-    sensor1_time = current_time;
 }
 
-// Interrupção do Sensor 2 (cálculo de velocidade)
-void sensor2_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+// Sem bordas por tempo suficiente: o veículo terminou de passar
+static void lane_timer_expiry(struct k_timer *timer)
 {
-    if (sensor1_triggered) {
-        sensor2_time = k_uptime_get_32();
-        
-        // Prepara dados do veículo
-        vehicle_data_t vehicle_data = {
-            .timestamp = k_uptime_get_32(),
-            .time_between_sensors = sensor2_time - sensor1_time,
-            .axle_count = axle_count
-        };
-        
-        // Classifica veículo baseado no número de eixos
-        if (axle_count >= 3) {
-            vehicle_data.type = VEHICLE_HEAVY;
-        } else if (axle_count == 2) {
-            vehicle_data.type = VEHICLE_LIGHT;
-        } else {
-            vehicle_data.type = VEHICLE_UNKNOWN;
-        }
-        
-        // Envia dados para a thread de controle
-        k_msgq_put(&vehicle_data_queue, &vehicle_data, K_NO_WAIT);
-        
-        // Reseta contadores
-        axle_count = 0;
-        sensor1_triggered = false;
+    uint8_t lane = (uint8_t)(uintptr_t)k_timer_user_data_get(timer);
+    k_spinlock_key_t key = k_spin_lock(&lane_locks[lane]);
+
+    sensor_lane_poll(lane, radar_now_us());
+
+    k_spin_unlock(&lane_locks[lane], key);
+}
+
+static void sensor_lane_edge(uint8_t lane, radar_sensor_t sensor, uint32_t now_us)
+{
+    k_spinlock_key_t key = k_spin_lock(&lane_locks[lane]);
+
+    axle_edge_t edge = axle_detector_edge(&lane_detectors[lane], sensor, now_us);
+
+    // Infração prevista na borda: a câmera prende os quadros já, sem esperar
+    // o veículo liberar os sensores nem o estágio de decisão. A classe
+    // estimada nos eixos seguintes pode desfazer a previsão.
+    if (edge == AXLE_EDGE_SPEEDING) {
+        radar_camera_prearm(lane, now_us);
+    } else if (edge == AXLE_EDGE_CLEARED) {
+        radar_camera_release(lane, CAMERA_RELEASE_EDGE);
     }
+
+    // Bordas dentro da janela de debounce são descartadas pelo detector
+    if (edge != AXLE_EDGE_IGNORED) {
+        sensor_lane_poll(lane, now_us);
+    }
+
+    k_spin_unlock(&lane_locks[lane], key);
 }
 
-void sensor_thread(void *arg1, void *arg2, void *arg3)
+// Interrupção comum a todos os sensores: despacha a borda para a faixa
+void sensor_gpio_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
-    ARG_UNUSED(arg1);
-    ARG_UNUSED(arg2);
-    ARG_UNUSED(arg3);
-
-    gpio_dev = device_get_binding("GPIO_0");
-    if (!gpio_dev) {
-        printf("Erro: GPIO device not found\n");
-        return;
+    uint32_t now_us = radar_now_us();
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        if (pins & BIT(SENSOR_1_PIN_LANE(lane))) {
+            sensor_lane_edge(lane, RADAR_SENSOR_1, now_us);
+        }
+        if (pins & BIT(SENSOR_2_PIN_LANE(lane))) {
+            sensor_lane_edge(lane, RADAR_SENSOR_2, now_us);
+        }
     }
+}
+
+static int sensor_pin_init(gpio_pin_t pin)
+{
+    int ret = gpio_pin_configure(gpio_dev, pin, GPIO_INPUT | GPIO_PULL_UP);
 
-    // Configura Sensor 1 (contagem de eixos)
-    gpio_pin_configure(gpio_dev, SENSOR_1_PIN, 
-                      GPIO_INPUT | GPIO_PULL_UP | GPIO_INT_EDGE_FALLING);
-    gpio_init_callback(&sensor1_cb, sensor1_handler, BIT(SENSOR_1_PIN));
-    gpio_add_callback(gpio_dev, &sensor1_cb);
-    gpio_pin_interrupt_configure(gpio_dev, SENSOR_1_PIN, GPIO_INT_EDGE_FALLING);
-
-    // Configura Sensor 2 (velocidade)
-    gpio_pin_configure(gpio_dev, SENSOR_2_PIN, 
-                      GPIO_INPUT | GPIO_PULL_UP | GPIO_INT_EDGE_FALLING);
-    gpio_init_callback(&sensor2_cb, sensor2_handler, BIT(SENSOR_2_PIN));
-    gpio_add_callback(gpio_dev, &sensor2_cb);
-    gpio_pin_interrupt_configure(gpio_dev, SENSOR_2_PIN, GPIO_INT_EDGE_FALLING);
-
-    printf("Sensores inicializados - GPIO %d (eixos) e GPIO %d (velocidade)\n", 
-           SENSOR_1_PIN, SENSOR_2_PIN);
-
-    while (1) {
-        k_sleep(K_SECONDS(1));
+    if (ret == 0) {
+        ret = gpio_pin_interrupt_configure(gpio_dev, pin, GPIO_INT_EDGE_FALLING);
     }
+
+    return ret;
 }
 
-K_THREAD_DEFINE(sensor_thread_id, 2048, sensor_thread, NULL, NULL, NULL, 6, 0, 0);
\ No newline at end of file
+// Arma as interrupções dos sensores. Roda na primeira fase do boot: não
+// imprime nada e não depende de display, câmera ou logs. O erro é reportado
+// por main() quando o controlador não existe ou recusa a configuração.
+int sensor_interrupts_init(void)
+{
+    uint32_t pin_mask = 0;
+    int ret;
+
+    if (gpio_dev == NULL || !device_is_ready(gpio_dev)) {
+        return -ENODEV;
+    }
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        axle_detector_init(&lane_detectors[lane]);
+        k_timer_init(&lane_timers[lane], lane_timer_expiry, NULL);
+        k_timer_user_data_set(&lane_timers[lane], (void *)(uintptr_t)lane);
+        pin_mask |= BIT(SENSOR_1_PIN_LANE(lane)) | BIT(SENSOR_2_PIN_LANE(lane));
+    }
+
+    gpio_init_callback(&sensor_cb, sensor_gpio_handler, pin_mask);
+    gpio_add_callback(gpio_dev, &sensor_cb);
+
+    for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+        // Sensor 1 (contagem de eixos) e Sensor 2 (velocidade)
+        ret = sensor_pin_init(SENSOR_1_PIN_LANE(lane));
+        if (ret == 0) {
+            ret = sensor_pin_init(SENSOR_2_PIN_LANE(lane));
+        }
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+}
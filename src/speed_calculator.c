@@ -2,7 +2,12 @@
 
 void calculate_speed(vehicle_data_t *vehicle)
 {
-    if (vehicle->time_between_sensors == 0) {
+    // Prefere o tempo em us medido pelo detector de eixos
+    float time_ms = vehicle->time_between_sensors_us ?
+                    vehicle->time_between_sensors_us / 1000.0f :
+                    (float)vehicle->time_between_sensors;
+
+    if (time_ms <= 0.0f) {
         vehicle->speed_kmh = 0.0f;
         return;
     }
@@ -10,14 +15,86 @@ void calculate_speed(vehicle_data_t *vehicle)
     // Calcula velocidade em km/h
     // distância em metros / tempo em horas
     float distance_m = SENSOR_DISTANCE_MM / 1000.0f;
-    float time_h = vehicle->time_between_sensors / 3600000.0f; // ms para horas
+    float time_h = time_ms / 3600000.0f; // ms para horas
     
     vehicle->speed_kmh = distance_m / 1000.0f / time_h; // m/s para km/h
 }
 
+// Limites de cada classe convertidos no build em tempo mínimo entre os
+// sensores. Sem classe vale o menor limite, como em check_speed_status().
+static const uint32_t speed_limit_transit_us[] = {
+    [VEHICLE_UNKNOWN] = SPEED_LIMIT_TRANSIT_US(MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY)),
+    [VEHICLE_LIGHT] = SPEED_LIMIT_TRANSIT_US(SPEED_LIMIT_LIGHT),
+    [VEHICLE_HEAVY] = SPEED_LIMIT_TRANSIT_US(SPEED_LIMIT_HEAVY),
+};
+
+static const uint32_t speed_warning_transit_us[] = {
+    [VEHICLE_UNKNOWN] = SPEED_WARNING_TRANSIT_US(MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY)),
+    [VEHICLE_LIGHT] = SPEED_WARNING_TRANSIT_US(SPEED_LIMIT_LIGHT),
+    [VEHICLE_HEAVY] = SPEED_WARNING_TRANSIT_US(SPEED_LIMIT_HEAVY),
+};
+
+static size_t transit_limit_index(vehicle_type_t type)
+{
+    return (type == VEHICLE_LIGHT || type == VEHICLE_HEAVY) ? (size_t)type : VEHICLE_UNKNOWN;
+}
+
+// Infração pelo tempo entre os sensores, sem ponto flutuante: pode ser
+// chamada na interrupção do sensor 2
+bool speed_transit_exceeds_limit(uint32_t transit_us, vehicle_type_t type)
+{
+    if (transit_us == 0) {
+        return false;
+    }
+
+    return transit_us < speed_limit_transit_us[transit_limit_index(type)];
+}
+
+// Mesma decisão de check_speed_status(), em inteiros e exata no limite
+speed_status_t check_transit_status(uint32_t transit_us, vehicle_type_t type)
+{
+    if (transit_us == 0) {
+        return SPEED_NORMAL;
+    }
+
+    if (speed_transit_exceeds_limit(transit_us, type)) {
+        return SPEED_INFRACTION;
+    } else if (transit_us < speed_warning_transit_us[transit_limit_index(type)]) {
+        return SPEED_WARNING;
+    }
+
+    return SPEED_NORMAL;
+}
+
+// Status usado pela decisão e pelo display. Com o tempo em us medido, usa a
+// mesma regra inteira da previsão na borda do sensor 2, para que as duas
+// nunca divirjam no limite.
+speed_status_t vehicle_speed_status(const vehicle_data_t *vehicle)
+{
+    if (vehicle->time_between_sensors_us != 0) {
+        return check_transit_status(vehicle->time_between_sensors_us, vehicle->type);
+    }
+
+    return check_speed_status(vehicle->speed_kmh, vehicle->type);
+}
+
 speed_status_t check_speed_status(float speed, vehicle_type_t type)
 {
-    int speed_limit = (type == VEHICLE_LIGHT) ? SPEED_LIMIT_LIGHT : SPEED_LIMIT_HEAVY;
+    int speed_limit;
+
+    switch (type) {
+        case VEHICLE_LIGHT:
+            speed_limit = SPEED_LIMIT_LIGHT;
+            break;
+        case VEHICLE_HEAVY:
+            speed_limit = SPEED_LIMIT_HEAVY;
+            break;
+        default:
+            // Sem classe (radar Doppler, contagem de eixos inválida): limite mais baixo
+            speed_limit = MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY);
+            break;
+    }
+
     float warning_threshold = speed_limit * (WARNING_THRESHOLD / 100.0f);
     
     if (speed > speed_limit) {
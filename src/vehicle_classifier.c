@@ -0,0 +1,102 @@
+#include "radar.h"
+#include "vehicle_classifier_model.h"
+
+BUILD_ASSERT(CLASSIFIER_FEATURE_COUNT == CLASSIFIER_F_SPACING_1_MM + RADAR_MAX_AXLES - 1,
+             "Modelo do classificador gerado com outro numero de eixos");
+
+// Classificação original: só o número de eixos
+vehicle_type_t classify_vehicle_axle_count(const vehicle_data_t *data)
+{
+    if (data->axle_count >= 3) {
+        return VEHICLE_HEAVY;
+    } else if (data->axle_count == 2) {
+        return VEHICLE_LIGHT;
+    }
+
+    return VEHICLE_UNKNOWN;
+}
+
+// Árvore de decisão gerada no build. A árvore é completa: todo veículo
+// percorre CLASSIFIER_DEPTH níveis, e a comparação de cada nível vira o
+// índice do filho, sem desvios que dependam dos dados.
+static vehicle_type_t classifier_infer(const uint16_t *features)
+{
+    uint32_t node = 0;
+
+    for (int level = 0; level < CLASSIFIER_DEPTH; level++) {
+        node = 2U * node + 1U + (features[classifier_feature[node]] > classifier_threshold[node]);
+    }
+
+    return (vehicle_type_t)classifier_leaf[node - ((1U << CLASSIFIER_DEPTH) - 1U)];
+}
+
+vehicle_type_t classify_vehicle_model(const vehicle_data_t *data)
+{
+    uint16_t features[CLASSIFIER_FEATURE_COUNT];
+
+    features[CLASSIFIER_F_AXLE_COUNT] = data->axle_count;
+    features[CLASSIFIER_F_LENGTH_MM] = data->length_mm;
+    features[CLASSIFIER_F_SPEED_KMH] = (uint16_t)CLAMP(data->speed_kmh, 0.0f, (float)UINT16_MAX);
+    memcpy(&features[CLASSIFIER_F_SPACING_1_MM], data->axle_spacing_mm,
+           sizeof(data->axle_spacing_mm));
+
+    return classifier_infer(features);
+}
+
+// Mesma árvore com os eixos que já passaram pelo sensor 1, em inteiros para
+// rodar na interrupção. spacing_mm tem RADAR_MAX_AXLES - 1 posições, zeradas
+// além do último eixo. Com todos os eixos dá a classe da decisão.
+vehicle_type_t classify_vehicle_partial_model(uint8_t axle_count, const uint16_t *spacing_mm,
+                                              uint32_t transit_us)
+{
+    uint16_t features[CLASSIFIER_FEATURE_COUNT];
+    uint32_t length_mm = 0;
+    uint32_t speed_kmh = ((uint64_t)SENSOR_DISTANCE_MM * 3600U) / MAX(transit_us, 1U);
+
+    for (int i = 0; i < RADAR_MAX_AXLES - 1; i++) {
+        length_mm += spacing_mm[i];
+    }
+
+    features[CLASSIFIER_F_AXLE_COUNT] = axle_count;
+    features[CLASSIFIER_F_LENGTH_MM] = (uint16_t)MIN(length_mm, (uint32_t)UINT16_MAX);
+    features[CLASSIFIER_F_SPEED_KMH] = (uint16_t)MIN(speed_kmh, (uint32_t)UINT16_MAX);
+    memcpy(&features[CLASSIFIER_F_SPACING_1_MM], spacing_mm,
+           (RADAR_MAX_AXLES - 1) * sizeof(uint16_t));
+
+    return classifier_infer(features);
+}
+
+// Classe estimada na borda, antes de o veículo terminar de passar. Fica
+// VEHICLE_UNKNOWN, e a previsão no menor limite, enquanto a estratégia não
+// consegue separar as classes com os eixos já vistos.
+vehicle_type_t classify_vehicle_partial(uint8_t axle_count, const uint16_t *spacing_mm,
+                                        uint32_t transit_us)
+{
+    if (axle_count < 2) {
+        return VEHICLE_UNKNOWN;
+    }
+
+    if (CLASSIFICATION_BY_MODEL) {
+        return classify_vehicle_partial_model(axle_count, spacing_mm, transit_us);
+    }
+
+    // Pela contagem de eixos, dois eixos ainda podem ser o começo de um
+    // pesado: só o terceiro fixa a classe
+    return (axle_count >= 3) ? VEHICLE_HEAVY : VEHICLE_UNKNOWN;
+}
+
+// Chamada pelo estágio de decisão, depois do cálculo da velocidade
+vehicle_type_t classify_vehicle(const vehicle_data_t *data)
+{
+    // O radar Doppler não conta eixos: o veículo fica sem classe
+    if (data->axle_count == 0) {
+        return VEHICLE_UNKNOWN;
+    }
+
+    if (CLASSIFICATION_BY_MODEL) {
+        return classify_vehicle_model(data);
+    }
+
+    // CLASSIFICATION_BY_TIME ainda usa a contagem de eixos
+    return classify_vehicle_axle_count(data);
+}
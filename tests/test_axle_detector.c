@@ -0,0 +1,124 @@
+#include <ztest.h>
+#include "radar.h"
+
+#define MAX_TEST_EDGES      (4 * RADAR_MAX_AXLES)
+#define TEST_START_US       1000000U
+#define TEST_BOUNCE_US      1000U
+#define TEST_SPEED_MIN_KMH  10
+#define TEST_SPEED_MAX_KMH  250
+#define TEST_SPEED_STEP_KMH 10
+
+// Perfis de veículo com o caso crítico de 1,2 m entre eixos
+static const traffic_vehicle_t test_profiles[] = {
+    { .axle_count = 2, .axle_spacing_mm = { 1200 } },
+    { .axle_count = 2, .axle_spacing_mm = { 2600 } },
+    { .axle_count = 3, .axle_spacing_mm = { 4000, 1300 } },
+    { .axle_count = 5, .axle_spacing_mm = { 3600, 1300, 5000, 1300 } },
+};
+
+// Passa um veículo sintético pelo detector e devolve o registro gerado
+static bool run_vehicle(const traffic_vehicle_t *vehicle, vehicle_data_t *result)
+{
+    axle_detector_t det;
+    sensor_edge_t edges[MAX_TEST_EDGES];
+    size_t count = traffic_generate_edges(vehicle, TEST_START_US, edges, MAX_TEST_EDGES);
+
+    axle_detector_init(&det);
+
+    for (size_t i = 0; i < count; i++) {
+        axle_detector_edge(&det, edges[i].sensor, edges[i].time_us);
+        zassert_false(axle_detector_poll(&det, edges[i].time_us, result),
+                      "Veiculo encerrado antes do ultimo eixo");
+    }
+
+    uint32_t end_us = edges[count - 1].time_us +
+                      axle_detector_poll_delay_us(&det, edges[count - 1].time_us);
+
+    if (!axle_detector_poll(&det, end_us, result)) {
+        return false;
+    }
+
+    // O instante de encerramento vem das bordas, não de quando o poll rodou
+    zassert_equal(result->ready_us, end_us, "Encerramento fora do silencio apos a ultima borda");
+    // A última borda aceita; repiques depois dela são descartados
+    zassert_true(edges[count - 1].time_us - result->last_edge_us <= vehicle->bounce_us,
+                 "Ultima borda incorreta");
+    return true;
+}
+
+void test_debounce_window_scales_with_speed(void)
+{
+    uint32_t previous = UINT32_MAX;
+
+    for (uint32_t speed = TEST_SPEED_MIN_KMH; speed <= TEST_SPEED_MAX_KMH;
+         speed += TEST_SPEED_STEP_KMH) {
+        uint32_t transit_us = (SENSOR_DISTANCE_MM * 3600U) / speed;
+        uint32_t window = axle_debounce_window_us(transit_us);
+        uint32_t min_axle_gap_us = (MIN_AXLE_SPACING_MM * 3600U) / speed;
+
+        zassert_true(window <= previous, "Janela deve diminuir com a velocidade");
+        zassert_true(window < min_axle_gap_us, "Janela maior que o intervalo entre eixos");
+        zassert_true(window >= SENSOR_MIN_PULSE_US, "Janela abaixo do limite do sensor");
+        zassert_true(window <= DEBOUNCE_TIME_MS * 1000U, "Janela acima do debounce maximo");
+        previous = window;
+    }
+}
+
+void test_axle_count_across_speeds(void)
+{
+    for (size_t p = 0; p < ARRAY_SIZE(test_profiles); p++) {
+        for (uint32_t speed = TEST_SPEED_MIN_KMH; speed <= TEST_SPEED_MAX_KMH;
+             speed += TEST_SPEED_STEP_KMH) {
+            traffic_vehicle_t vehicle = test_profiles[p];
+            vehicle_data_t result;
+
+            vehicle.speed_kmh = speed;
+            vehicle.bounce_us = TEST_BOUNCE_US;
+
+            zassert_true(run_vehicle(&vehicle, &result), "Veiculo nao detectado");
+            zassert_equal(result.axle_count, vehicle.axle_count,
+                          "Contagem de eixos incorreta");
+            zassert_equal(result.type, VEHICLE_UNKNOWN,
+                          "Classificacao e feita no estagio de decisao");
+
+            for (uint8_t axle = 1; axle < vehicle.axle_count; axle++) {
+                float spacing = vehicle.axle_spacing_mm[axle - 1];
+
+                zassert_within((float)result.axle_spacing_mm[axle - 1], spacing,
+                               spacing * 0.02f, "Distancia entre eixos fora da tolerancia de 2%%");
+            }
+
+            calculate_speed(&result);
+            zassert_within(result.speed_kmh, (float)speed, speed * 0.02f,
+                           "Velocidade fora da tolerancia de 2%%");
+        }
+    }
+}
+
+void test_abandoned_vehicle_dropped(void)
+{
+    axle_detector_t det;
+    vehicle_data_t result;
+
+    // Pulso no sensor 1 sem passagem pelo sensor 2
+    axle_detector_init(&det);
+    zassert_true(axle_detector_edge(&det, RADAR_SENSOR_1, TEST_START_US), NULL);
+    zassert_false(axle_detector_edge(&det, RADAR_SENSOR_1, TEST_START_US + TEST_BOUNCE_US),
+                  "Repique deveria ser descartado");
+
+    uint32_t end_us = TEST_START_US + AXLE_TIMEOUT_MS * 1000U;
+
+    zassert_false(axle_detector_poll(&det, end_us, &result),
+                  "Veiculo sem sensor 2 nao deveria ser enviado");
+    zassert_equal(axle_detector_poll_delay_us(&det, end_us), 0, NULL);
+}
+
+void test_axle_detector_suite(void)
+{
+    ztest_test_suite(radar_axle_detector_tests,
+        ztest_unit_test(test_debounce_window_scales_with_speed),
+        ztest_unit_test(test_axle_count_across_speeds),
+        ztest_unit_test(test_abandoned_vehicle_dropped)
+    );
+    ztest_run_test_suite(radar_axle_detector_tests);
+}
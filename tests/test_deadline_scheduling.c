@@ -0,0 +1,98 @@
+#include <ztest.h>
+#include "radar.h"
+
+#define LOAD_TEST_VEHICLES      20
+#define LOAD_TEST_HEADWAY_MS    25
+#define LOAD_TEST_DURATION_MS   (LOAD_TEST_VEHICLES * LOAD_TEST_HEADWAY_MS + 500)
+#define HOG_STACK_SIZE          1024
+
+static K_THREAD_STACK_DEFINE(display_hog_stack, HOG_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(camera_hog_stack, HOG_STACK_SIZE);
+static struct k_thread display_hog_thread;
+static struct k_thread camera_hog_thread;
+
+// Ocupa a CPU na prioridade de um estágio até o fim do teste
+static void cpu_hog(void *arg1, void *arg2, void *arg3)
+{
+    ARG_UNUSED(arg2);
+    ARG_UNUSED(arg3);
+
+    uint32_t end = (uint32_t)(uintptr_t)arg1;
+
+    while ((int32_t)(end - k_uptime_get_32()) > 0) {
+        k_busy_wait(1000);
+    }
+}
+
+void test_deadline_priority_layout(void)
+{
+    // Prioridades numéricas menores são mais prioritárias no Zephyr
+    zassert_true(RADAR_PRIO_SENSOR < RADAR_PRIO_DECISION,
+                 "Sensores devem preceder a decisao");
+
+    if (DEADLINE_DECISION_MS < DEADLINE_DISPLAY_MS) {
+        zassert_true(RADAR_PRIO_DECISION < RADAR_PRIO_DISPLAY,
+                     "Decisao deve preceder o display");
+    }
+    if (DEADLINE_DECISION_MS < DEADLINE_CAMERA_MS) {
+        zassert_true(RADAR_PRIO_DECISION < RADAR_PRIO_CAMERA,
+                     "Decisao deve preceder a camera");
+    }
+}
+
+void test_deadline_decision_under_load(void)
+{
+    uint32_t misses_before = radar_deadline_misses(RADAR_STAGE_DECISION);
+    uint32_t done_before = radar_deadline_completed(RADAR_STAGE_DECISION);
+    uint32_t end = k_uptime_get_32() + LOAD_TEST_DURATION_MS;
+    int old_prio = k_thread_priority_get(k_current_get());
+
+    // Injeta veículos com a prioridade dos sensores (simula as interrupções)
+    k_thread_priority_set(k_current_get(), RADAR_PRIO_SENSOR);
+
+    // Satura display e câmera
+    k_thread_create(&display_hog_thread, display_hog_stack, HOG_STACK_SIZE,
+                    cpu_hog, (void *)(uintptr_t)end, NULL, NULL,
+                    RADAR_PRIO_DISPLAY, 0, K_NO_WAIT);
+    k_thread_create(&camera_hog_thread, camera_hog_stack, HOG_STACK_SIZE,
+                    cpu_hog, (void *)(uintptr_t)end, NULL, NULL,
+                    RADAR_PRIO_CAMERA, 0, K_NO_WAIT);
+
+    for (int i = 0; i < LOAD_TEST_VEHICLES; i++) {
+        vehicle_data_t vehicle = {
+            .timestamp = k_uptime_get_32(),
+            .release_time = k_uptime_get_32(),
+            // Alterna veículos normais (18 km/h) e infratores (180 km/h)
+            .time_between_sensors = (i % 2) ? 10 : 100,
+            .axle_count = 2,
+            .type = VEHICLE_LIGHT
+        };
+
+        zassert_equal(radar_pipeline_submit(&vehicle), 0,
+                      "Fila de veiculos cheia");
+        k_msleep(LOAD_TEST_HEADWAY_MS);
+    }
+
+    k_thread_join(&display_hog_thread, K_FOREVER);
+    k_thread_join(&camera_hog_thread, K_FOREVER);
+    k_thread_priority_set(k_current_get(), old_prio);
+
+    TC_PRINT("Decisao: %u veiculos, %u prazos perdidos, pior caso %u ms (prazo %u ms)\n",
+             radar_deadline_completed(RADAR_STAGE_DECISION) - done_before,
+             radar_deadline_misses(RADAR_STAGE_DECISION) - misses_before,
+             radar_deadline_worst_ms(RADAR_STAGE_DECISION), DEADLINE_DECISION_MS);
+
+    zassert_equal(radar_deadline_completed(RADAR_STAGE_DECISION) - done_before,
+                  LOAD_TEST_VEHICLES, "Nem todos os veiculos foram decididos");
+    zassert_equal(radar_deadline_misses(RADAR_STAGE_DECISION), misses_before,
+                  "Decisao perdeu prazo com display e camera saturados");
+}
+
+void test_deadline_suite(void)
+{
+    ztest_test_suite(radar_deadline_tests,
+        ztest_unit_test(test_deadline_priority_layout),
+        ztest_unit_test(test_deadline_decision_under_load)
+    );
+    ztest_run_test_suite(radar_deadline_tests);
+}
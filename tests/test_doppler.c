@@ -0,0 +1,236 @@
+#include <ztest.h>
+#include "radar.h"
+
+#define TEST_SPEED_MIN_KMH  10
+#define TEST_SPEED_MAX_KMH  250
+#define TEST_SPEED_STEP_KMH 10
+#define TEST_AMPLITUDE      8000
+#define TEST_NOISE          2000
+#define BENCH_BLOCKS        200
+
+static radar_q15_t test_block[2 * DOPPLER_FFT_SIZE];
+
+// Tolerância de velocidade: 1% ou 0,5 km/h, o que for maior
+static bool speed_ok(uint32_t speed_ckmh, uint32_t expected_kmh)
+{
+    uint32_t tolerance = MAX(expected_kmh, 50U);
+
+    return (uint32_t)abs((int32_t)speed_ckmh - (int32_t)(expected_kmh * 100U)) <= tolerance;
+}
+
+void test_doppler_speed_accuracy(void)
+{
+    uint32_t total = 0;
+    uint32_t correct = 0;
+    uint32_t worst_error = 0;
+
+    doppler_dsp_init();
+
+    for (int receding = 0; receding <= 1; receding++) {
+        for (uint32_t speed = TEST_SPEED_MIN_KMH; speed <= TEST_SPEED_MAX_KMH;
+             speed += TEST_SPEED_STEP_KMH) {
+            traffic_doppler_t target = {
+                .speed_kmh = speed,
+                .beam_ms = 1000,
+                .amplitude = TEST_AMPLITUDE,
+                .noise = TEST_NOISE,
+                .receding = receding,
+            };
+            traffic_iq_t gen;
+            doppler_peak_t peak;
+
+            traffic_iq_init(&gen, &target);
+            traffic_iq_generate(&gen, test_block, DOPPLER_FFT_SIZE);
+
+            total++;
+            zassert_true(doppler_estimate(test_block, &peak), "Veiculo nao detectado");
+            zassert_equal(peak.bin_q8 < 0, receding, "Sentido incorreto");
+
+            uint32_t error = abs((int32_t)peak.speed_ckmh - (int32_t)(speed * 100U));
+
+            worst_error = MAX(worst_error, error);
+            if (speed_ok(peak.speed_ckmh, speed)) {
+                correct++;
+            }
+        }
+    }
+
+    TC_PRINT("Doppler de %d a %d km/h: %u/%u blocos na tolerancia, pior erro %u.%02u km/h\n",
+             TEST_SPEED_MIN_KMH, TEST_SPEED_MAX_KMH, correct, total,
+             worst_error / 100U, worst_error % 100U);
+    zassert_equal(correct, total, "Velocidade fora da tolerancia");
+}
+
+void test_doppler_noise_only(void)
+{
+    traffic_doppler_t target = { .speed_kmh = 80, .beam_ms = 0, .noise = TEST_NOISE };
+    traffic_iq_t gen;
+    doppler_peak_t peak;
+
+    doppler_dsp_init();
+    traffic_iq_init(&gen, &target);
+
+    for (int block = 0; block < 50; block++) {
+        traffic_iq_generate(&gen, test_block, DOPPLER_FFT_SIZE);
+        zassert_false(doppler_estimate(test_block, &peak), "Falso alvo no ruido");
+    }
+}
+
+void test_doppler_vehicle_record(void)
+{
+    traffic_doppler_t target = {
+        .speed_kmh = 72,
+        .beam_ms = 300,
+        .amplitude = TEST_AMPLITUDE,
+        .noise = TEST_NOISE,
+    };
+    uint32_t blocks = (target.beam_ms * 1000U) / DOPPLER_BLOCK_US + DOPPLER_HOLD_BLOCKS + 1;
+    doppler_detector_t det;
+    vehicle_data_t vehicle;
+    traffic_iq_t gen;
+    int vehicles = 0;
+
+    doppler_dsp_init();
+    doppler_detector_init(&det);
+    traffic_iq_init(&gen, &target);
+
+    for (uint32_t block = 0; block < blocks; block++) {
+        doppler_peak_t peak;
+        bool found;
+
+        traffic_iq_generate(&gen, test_block, DOPPLER_FFT_SIZE);
+        found = doppler_estimate(test_block, &peak);
+
+        if (doppler_detector_block(&det, found ? &peak : NULL, &vehicle)) {
+            vehicles++;
+        }
+    }
+
+    zassert_equal(vehicles, 1, "Um veiculo deveria ser enviado");
+    zassert_equal(vehicle.direction, DIRECTION_FORWARD, NULL);
+    zassert_equal(vehicle.type, VEHICLE_UNKNOWN, NULL);
+
+    // O estágio de decisão recupera a velocidade pelo tempo equivalente
+    calculate_speed(&vehicle);
+    zassert_within(vehicle.speed_kmh, 72.0f, 0.72f, "Velocidade fora da tolerancia de 1%%");
+}
+
+// Vazão e latência do processamento de blocos, comparados ao tempo real. A
+// fonte sintética roda na mesma fila de trabalho que o processamento, então o
+// custo de gerar o bloco entra na conta.
+void test_doppler_benchmark(void)
+{
+    traffic_doppler_t target = {
+        .speed_kmh = 90,
+        .beam_ms = 100000,
+        .amplitude = TEST_AMPLITUDE,
+        .noise = TEST_NOISE,
+    };
+    doppler_detector_t det;
+    vehicle_data_t vehicle;
+    traffic_iq_t gen;
+    doppler_peak_t peak;
+    uint32_t worst_cycles = 0;
+    uint64_t generate_cycles = 0;
+    uint64_t total_cycles = 0;
+
+    doppler_dsp_init();
+    doppler_detector_init(&det);
+    traffic_iq_init(&gen, &target);
+
+    for (int i = 0; i < BENCH_BLOCKS; i++) {
+        uint32_t start = k_cycle_get_32();
+
+        traffic_iq_generate(&gen, test_block, DOPPLER_FFT_SIZE);
+
+        uint32_t generated = k_cycle_get_32();
+        bool found = doppler_estimate(test_block, &peak);
+
+        doppler_detector_block(&det, found ? &peak : NULL, &vehicle);
+
+        uint32_t cycles = k_cycle_get_32() - start;
+
+        worst_cycles = MAX(worst_cycles, cycles);
+        generate_cycles += generated - start;
+        total_cycles += cycles;
+    }
+
+    uint32_t mean_us = MAX(k_cyc_to_us_floor32(total_cycles / BENCH_BLOCKS), 1U);
+    uint32_t generate_us = k_cyc_to_us_floor32(generate_cycles / BENCH_BLOCKS);
+    uint32_t worst_us = k_cyc_to_us_floor32(worst_cycles);
+    uint32_t samples_per_s = (uint32_t)(((uint64_t)DOPPLER_FFT_SIZE * 1000000U) / mean_us);
+
+    TC_PRINT("Doppler: FFT de %d pontos, bloco de %u us a %d amostras/s\n",
+             DOPPLER_FFT_SIZE, DOPPLER_BLOCK_US, DOPPLER_SAMPLE_RATE_HZ);
+    TC_PRINT("  Por bloco: media %u us (%u ciclos, geracao sintetica %u us), "
+             "pior %u us (%u ciclos), %u%% da CPU\n",
+             mean_us, (uint32_t)(total_cycles / BENCH_BLOCKS), generate_us,
+             worst_us, worst_cycles, (mean_us * 100U) / DOPPLER_BLOCK_US);
+    TC_PRINT("  Capacidade: %u amostras/s (%u.%02ux o tempo real)\n",
+             samples_per_s, samples_per_s / DOPPLER_SAMPLE_RATE_HZ,
+             (samples_per_s % DOPPLER_SAMPLE_RATE_HZ) * 100U / DOPPLER_SAMPLE_RATE_HZ);
+
+    zassert_true(worst_us < DOPPLER_BLOCK_US, "Processamento nao acompanha a aquisicao");
+}
+
+// Latência medida entre a saída do veículo do feixe e o envio do registro:
+// espera até o fim do bloco em que o detector encerra o veículo, no relógio
+// das amostras, mais o processamento medido desse bloco
+void test_doppler_exit_latency(void)
+{
+    traffic_doppler_t target = {
+        .speed_kmh = 90,
+        .beam_ms = 300,
+        .amplitude = TEST_AMPLITUDE,
+        .noise = TEST_NOISE,
+    };
+    uint32_t beam_end_us = target.beam_ms * 1000U;
+    uint32_t max_blocks = beam_end_us / DOPPLER_BLOCK_US + DOPPLER_HOLD_BLOCKS + 2;
+    doppler_detector_t det;
+    vehicle_data_t vehicle;
+    traffic_iq_t gen;
+    bool sent = false;
+    uint32_t latency_us = 0;
+
+    doppler_dsp_init();
+    doppler_detector_init(&det);
+    traffic_iq_init(&gen, &target);
+
+    for (uint32_t block = 0; block < max_blocks && !sent; block++) {
+        doppler_peak_t peak;
+
+        traffic_iq_generate(&gen, test_block, DOPPLER_FFT_SIZE);
+
+        uint32_t start = k_cycle_get_32();
+        bool found = doppler_estimate(test_block, &peak);
+
+        sent = doppler_detector_block(&det, found ? &peak : NULL, &vehicle);
+
+        if (sent) {
+            uint32_t block_end_us = (uint32_t)(((uint64_t)(block + 1) * DOPPLER_FFT_SIZE *
+                                                1000000U) / DOPPLER_SAMPLE_RATE_HZ);
+
+            latency_us = (block_end_us - beam_end_us) +
+                         k_cyc_to_us_floor32(k_cycle_get_32() - start);
+        }
+    }
+
+    zassert_true(sent, "Veiculo nao enviado apos sair do feixe");
+
+    TC_PRINT("Doppler: latencia saida do feixe -> veiculo enviado: %u us (medida)\n",
+             latency_us);
+    zassert_true(latency_us <= (DOPPLER_HOLD_BLOCKS + 2) * DOPPLER_BLOCK_US,
+                 "Veiculo retido alem dos blocos de espera");
+}
+
+void test_doppler_suite(void)
+{
+    ztest_test_suite(radar_doppler_tests,
+        ztest_unit_test(test_doppler_speed_accuracy),
+        ztest_unit_test(test_doppler_noise_only),
+        ztest_unit_test(test_doppler_vehicle_record),
+        ztest_unit_test(test_doppler_benchmark),
+        ztest_unit_test(test_doppler_exit_latency)
+    );
+    ztest_run_test_suite(radar_doppler_tests);
+}
@@ -0,0 +1,440 @@
+#include <ztest.h>
+#include "radar.h"
+#include "vehicle_classifier_heldout.h"
+
+#define MAX_TEST_EDGES          (4 * RADAR_MAX_AXLES)
+#define TEST_START_US           1000000U
+#define TEST_TRANSIT_MARGIN_US  200
+#define TEST_LIMIT_MIN_KMH      20
+#define TEST_LIMIT_MAX_KMH      200
+
+// Varredura de velocidades da taxa de falsos pré-disparos (km/h)
+#define SWEEP_MIN_KMH           40
+#define SWEEP_MAX_KMH           120
+
+#define LOAD_TEST_VEHICLES      3     // Cabe na fila de capturas da câmera
+#define LOAD_TEST_SPEED_KMH     100
+#define LOAD_TEST_HEADWAY_MS    100
+#define LOAD_TEST_DURATION_MS   (LOAD_TEST_VEHICLES * 1000)
+#define HOG_STACK_SIZE          1024
+
+static K_THREAD_STACK_DEFINE(output_hog_stack, HOG_STACK_SIZE);
+static struct k_thread output_hog_thread;
+
+static const vehicle_type_t test_types[] = { VEHICLE_UNKNOWN, VEHICLE_LIGHT, VEHICLE_HEAVY };
+
+// Ocupa a CPU na prioridade da fila de saída até o fim do teste
+static void output_hog(void *arg1, void *arg2, void *arg3)
+{
+    ARG_UNUSED(arg2);
+    ARG_UNUSED(arg3);
+
+    uint32_t end = (uint32_t)(uintptr_t)arg1;
+
+    while ((int32_t)(end - k_uptime_get_32()) > 0) {
+        k_busy_wait(1000);
+    }
+}
+
+// Regra exata: acima do limite quando tempo * limite < distância * 3600
+static bool transit_over(uint32_t transit_us, uint32_t limit_kmh, uint32_t percent)
+{
+    return (uint64_t)transit_us * limit_kmh * percent <
+           (uint64_t)SENSOR_DISTANCE_MM * 3600U * 100U;
+}
+
+// Os tempos-limite do build seguem a regra exata para qualquer limite, não
+// só os configurados (por exemplo 64, 72 e 75 km/h)
+void test_transit_limit_exact_for_any_limit(void)
+{
+    for (uint32_t limit = TEST_LIMIT_MIN_KMH; limit <= TEST_LIMIT_MAX_KMH; limit++) {
+        uint32_t limit_us = SPEED_LIMIT_TRANSIT_US(limit);
+        uint32_t warning_us = SPEED_WARNING_TRANSIT_US(limit);
+
+        for (uint32_t transit = limit_us - 2; transit <= limit_us + 2; transit++) {
+            zassert_equal(transit < limit_us, transit_over(transit, limit, 100),
+                          "Limite de %u km/h diverge em %u us", limit, transit);
+        }
+        for (uint32_t transit = warning_us - 2; transit <= warning_us + 2; transit++) {
+            zassert_equal(transit < warning_us, transit_over(transit, limit, WARNING_THRESHOLD),
+                          "Alerta de %u km/h diverge em %u us", limit, transit);
+        }
+    }
+}
+
+// Previsão na borda e status da decisão usam a mesma regra em torno do
+// limite de cada classe
+void test_transit_limit_matches_status(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(test_types); i++) {
+        vehicle_type_t type = test_types[i];
+        uint32_t limit = (type == VEHICLE_LIGHT) ? SPEED_LIMIT_LIGHT :
+                         (type == VEHICLE_HEAVY) ? SPEED_LIMIT_HEAVY :
+                         MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY);
+        uint32_t limit_us = SPEED_LIMIT_TRANSIT_US(limit);
+
+        for (uint32_t transit = limit_us - TEST_TRANSIT_MARGIN_US;
+             transit <= limit_us + TEST_TRANSIT_MARGIN_US; transit++) {
+            vehicle_data_t vehicle = { .time_between_sensors_us = transit, .type = type };
+            speed_status_t status = vehicle_speed_status(&vehicle);
+
+            zassert_equal(speed_transit_exceeds_limit(transit, type),
+                          status == SPEED_INFRACTION,
+                          "Previsao diverge da decisao em %u us", transit);
+            zassert_equal(status == SPEED_INFRACTION, transit_over(transit, limit, 100),
+                          "Decisao fora da regra exata em %u us", transit);
+        }
+    }
+}
+
+// A previsão sai na borda do primeiro eixo no sensor 2, uma vez por veículo
+void test_prediction_on_first_axle(void)
+{
+    static const struct {
+        uint32_t speed_kmh;
+        bool predicted;
+    } cases[] = {
+        { 50, false },
+        { MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY) + 5, true },
+        { MAX(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY) + 20, true },
+    };
+
+    for (size_t c = 0; c < ARRAY_SIZE(cases); c++) {
+        traffic_vehicle_t vehicle = {
+            .speed_kmh = cases[c].speed_kmh,
+            .axle_count = 3,
+            .axle_spacing_mm = { 4000, 1300 },
+        };
+        sensor_edge_t edges[MAX_TEST_EDGES];
+        size_t count = traffic_generate_edges(&vehicle, TEST_START_US, edges, MAX_TEST_EDGES);
+        uint32_t first_sensor2_us = 0;
+        int speeding_edges = 0;
+        axle_detector_t det;
+        vehicle_data_t result;
+
+        axle_detector_init(&det);
+
+        for (size_t i = 0; i < count; i++) {
+            axle_edge_t edge = axle_detector_edge(&det, edges[i].sensor, edges[i].time_us);
+
+            if (edges[i].sensor == RADAR_SENSOR_2 && first_sensor2_us == 0) {
+                first_sensor2_us = edges[i].time_us;
+                zassert_equal(edge == AXLE_EDGE_SPEEDING, cases[c].predicted,
+                              "Previsao incorreta a %u km/h", cases[c].speed_kmh);
+            } else {
+                zassert_not_equal(edge, AXLE_EDGE_SPEEDING, "Previsao repetida");
+            }
+            speeding_edges += (edge == AXLE_EDGE_SPEEDING);
+        }
+
+        uint32_t end_us = edges[count - 1].time_us +
+                          axle_detector_poll_delay_us(&det, edges[count - 1].time_us);
+
+        zassert_true(axle_detector_poll(&det, end_us, &result), "Veiculo nao detectado");
+        zassert_equal(result.infraction_predicted, cases[c].predicted, NULL);
+        zassert_equal(result.sensor2_us, first_sensor2_us, NULL);
+        zassert_equal(speeding_edges, cases[c].predicted ? 1 : 0, NULL);
+    }
+}
+
+// Bordas de um veículo no detector: pré-disparos, previsões desfeitas e o
+// tempo com quadros presos por elas, e o registro entregue à decisão, já com
+// velocidade e classe
+typedef struct {
+    uint32_t speeding;
+    uint32_t cleared;
+    uint32_t cleared_pinned_us;  // Do pré-disparo até a borda que o desfez
+    uint32_t armed_us;           // Borda do pré-disparo em vigor
+    uint32_t sensor2_us;         // Primeiro eixo no sensor 2
+    bool first_predicted;        // Previsão no primeiro eixo, no menor limite
+    vehicle_data_t result;
+} edge_outcome_t;
+
+static void run_vehicle_edges(const traffic_vehicle_t *vehicle, edge_outcome_t *out)
+{
+    sensor_edge_t edges[MAX_TEST_EDGES];
+    size_t count = traffic_generate_edges(vehicle, TEST_START_US, edges, MAX_TEST_EDGES);
+    axle_detector_t det;
+
+    memset(out, 0, sizeof(*out));
+    axle_detector_init(&det);
+
+    for (size_t i = 0; i < count; i++) {
+        axle_edge_t edge = axle_detector_edge(&det, edges[i].sensor, edges[i].time_us);
+
+        if (edges[i].sensor == RADAR_SENSOR_2 && edge != AXLE_EDGE_IGNORED &&
+            out->sensor2_us == 0) {
+            out->sensor2_us = edges[i].time_us;
+            out->first_predicted = edge == AXLE_EDGE_SPEEDING;
+        }
+
+        if (edge == AXLE_EDGE_SPEEDING) {
+            out->speeding++;
+            out->armed_us = edges[i].time_us;
+        } else if (edge == AXLE_EDGE_CLEARED) {
+            out->cleared++;
+            out->cleared_pinned_us += edges[i].time_us - out->armed_us;
+        }
+    }
+
+    uint32_t end_us = edges[count - 1].time_us +
+                      axle_detector_poll_delay_us(&det, edges[count - 1].time_us);
+
+    zassert_true(axle_detector_poll(&det, end_us, &out->result), "Veiculo nao detectado");
+
+    calculate_speed(&out->result);
+    out->result.type = classify_vehicle(&out->result);
+}
+
+// Entre o limite de pesados e o de leves, a previsão do primeiro eixo é
+// refeita com a classe estimada nos eixos seguintes. Pelo modelo o carro é
+// separado no segundo eixo e o cavalo com semirreboque, que começa como um
+// utilitário, volta a pré-armar no terceiro; pela contagem de eixos só a
+// decisão separa as classes.
+void test_prediction_refined_by_class(void)
+{
+    static const struct {
+        traffic_vehicle_t vehicle;
+        uint32_t speeding_model;
+        uint32_t cleared_model;
+    } cases[] = {
+        { { .axle_count = 2, .axle_spacing_mm = { 2600 } }, 1, 1 },
+        { { .axle_count = 3, .axle_spacing_mm = { 4300, 1370 } }, 1, 0 },
+        { { .axle_count = 5, .axle_spacing_mm = { 3500, 1350, 5800, 1250 } }, 2, 1 },
+    };
+
+    if (SPEED_LIMIT_LIGHT <= SPEED_LIMIT_HEAVY) {
+        ztest_test_skip();
+        return;
+    }
+
+    for (size_t c = 0; c < ARRAY_SIZE(cases); c++) {
+        traffic_vehicle_t vehicle = cases[c].vehicle;
+        edge_outcome_t out;
+
+        vehicle.speed_kmh = (SPEED_LIMIT_LIGHT + SPEED_LIMIT_HEAVY) / 2;
+        run_vehicle_edges(&vehicle, &out);
+
+        zassert_true(out.first_predicted, "Primeiro eixo deveria pre-armar no menor limite");
+        zassert_equal(out.speeding, CLASSIFICATION_BY_MODEL ? cases[c].speeding_model : 1,
+                      "Caso %u: pre-disparos", (unsigned int)c);
+        zassert_equal(out.cleared, CLASSIFICATION_BY_MODEL ? cases[c].cleared_model : 0,
+                      "Caso %u: previsoes desfeitas", (unsigned int)c);
+        zassert_equal(out.result.infraction_predicted, out.speeding > out.cleared, NULL);
+    }
+}
+
+#define SWEEP_VEHICLE(name, type, speed, axles, ...) \
+    { 0, axles, { __VA_ARGS__ } },
+
+// Falsos pré-disparos nos veículos do conjunto de avaliação fixo, em toda a
+// faixa de velocidades, com a previsão só no menor limite e com a classe
+// estimada na borda. A decisão libera os quadros no mínimo quando o veículo
+// fica completo (ready_us); uma previsão desfeita os libera na borda.
+// Nenhuma infração confirmada pela decisão pode ficar sem pré-disparo.
+void test_false_prearm_rate(void)
+{
+    static const traffic_vehicle_t vehicles[] = {
+        CLASSIFIER_HELDOUT_VEHICLES(SWEEP_VEHICLE)
+    };
+    uint32_t first_prearms = 0;
+    uint32_t first_false = 0;
+    uint64_t first_pinned_us = 0;
+    uint32_t prearms = 0;
+    uint32_t cleared = 0;
+    uint32_t held_false = 0;
+    uint64_t pinned_us = 0;
+    uint32_t rearmed = 0;
+    uint32_t missed = 0;
+
+    for (size_t n = 0; n < ARRAY_SIZE(vehicles); n++) {
+        for (uint32_t speed = SWEEP_MIN_KMH; speed <= SWEEP_MAX_KMH; speed++) {
+            traffic_vehicle_t vehicle = vehicles[n];
+            edge_outcome_t out;
+
+            vehicle.speed_kmh = speed;
+            run_vehicle_edges(&vehicle, &out);
+
+            bool infraction = vehicle_speed_status(&out.result) == SPEED_INFRACTION;
+            bool held = out.result.infraction_predicted && !infraction;
+
+            first_prearms += out.first_predicted;
+            if (out.first_predicted && !infraction) {
+                first_false++;
+                first_pinned_us += out.result.ready_us - out.sensor2_us;
+            }
+
+            prearms += out.speeding;
+            cleared += out.cleared;
+            pinned_us += out.cleared_pinned_us;
+            if (held) {
+                held_false++;
+                pinned_us += out.result.ready_us - out.armed_us;
+            }
+            rearmed += out.speeding > 1;
+            missed += infraction && !out.result.infraction_predicted;
+        }
+    }
+
+    uint32_t false_prearms = cleared + held_false;
+
+    TC_PRINT("Falsos pre-disparos, %u veiculos de %u a %u km/h:\n",
+             (unsigned int)ARRAY_SIZE(vehicles), SWEEP_MIN_KMH, SWEEP_MAX_KMH);
+    TC_PRINT("  Menor limite no primeiro eixo: %u de %u (%u%%), todos ate a decisao, "
+             "quadros presos %u ms\n",
+             first_false, first_prearms, first_prearms ? first_false * 100U / first_prearms : 0,
+             (uint32_t)(first_pinned_us / 1000U));
+    TC_PRINT("  Com a classe estimada na borda: %u de %u (%u%%), %u desfeitos na borda, "
+             "%u ate a decisao, quadros presos %u ms, %u rearmado(s)\n",
+             false_prearms, prearms, prearms ? false_prearms * 100U / prearms : 0,
+             cleared, held_false, (uint32_t)(pinned_us / 1000U), rearmed);
+
+    zassert_equal(missed, 0, "Infracao confirmada sem pre-disparo");
+    zassert_true(held_false <= first_false, "Mais falsos pre-disparos chegaram a decisao");
+    zassert_true(pinned_us <= first_pinned_us, "Falsos pre-disparos prendem quadros por mais tempo");
+    if (CLASSIFICATION_BY_MODEL && SPEED_LIMIT_LIGHT > SPEED_LIMIT_HEAVY) {
+        zassert_true(pinned_us < first_pinned_us, "Classe estimada nao desfez nenhuma previsao");
+    }
+}
+
+// Veículo descartado depois de pré-armar a câmera: o detector informa, para
+// que o estágio de sensores libere os quadros presos
+void test_dropped_prediction_reported(void)
+{
+    traffic_vehicle_t vehicle = {
+        .speed_kmh = MAX(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY) + 20,
+        .axle_count = 2,
+        .axle_spacing_mm = { 2600 },
+    };
+    sensor_edge_t edges[MAX_TEST_EDGES];
+    size_t count = traffic_generate_edges(&vehicle, TEST_START_US, edges, MAX_TEST_EDGES);
+    uint32_t last_us = 0;
+    axle_detector_t det;
+    vehicle_data_t result;
+    bool predicted = false;
+
+    axle_detector_init(&det);
+
+    // O segundo eixo nunca chega ao sensor 2
+    for (size_t i = 0; i < count; i++) {
+        if (edges[i].sensor == RADAR_SENSOR_2 && predicted) {
+            continue;
+        }
+        predicted |= axle_detector_edge(&det, edges[i].sensor, edges[i].time_us) ==
+                     AXLE_EDGE_SPEEDING;
+        last_us = edges[i].time_us;
+    }
+
+    zassert_true(predicted, "Infracao deveria ser prevista");
+    zassert_equal(axle_detector_take_dropped_predictions(&det), 0, NULL);
+
+    zassert_false(axle_detector_poll(&det, last_us + AXLE_TIMEOUT_MS * 1000U, &result),
+                  "Veiculo incompleto nao deveria ser enviado");
+    zassert_equal(det.dropped_tracks, 1, NULL);
+    zassert_equal(axle_detector_take_dropped_predictions(&det), 1,
+                  "Pre-disparo do veiculo descartado nao informado");
+    zassert_equal(axle_detector_take_dropped_predictions(&det), 0, "Contagem nao zerada");
+}
+
+// Faz o papel do estágio de sensores em tempo real: cada borda é entregue ao
+// detector com o instante em que aconteceu, como o tempo lido na entrada da
+// interrupção, e o veículo é enviado à decisão ao ser encerrado. O atraso
+// para acordar esta thread faz o papel da latência da interrupção.
+static void drive_vehicle(const traffic_vehicle_t *vehicle)
+{
+    sensor_edge_t edges[MAX_TEST_EDGES];
+    size_t count = traffic_generate_edges(vehicle, radar_now_us() + 1000U, edges, MAX_TEST_EDGES);
+    axle_detector_t det;
+    vehicle_data_t vehicle_data;
+
+    axle_detector_init(&det);
+
+    for (size_t i = 0; i < count; i++) {
+        while ((int32_t)(edges[i].time_us - radar_now_us()) > 0) {
+            k_usleep(100);
+        }
+
+        axle_edge_t edge = axle_detector_edge(&det, edges[i].sensor, edges[i].time_us);
+
+        if (edge == AXLE_EDGE_SPEEDING) {
+            radar_camera_prearm(0, edges[i].time_us);
+        } else if (edge == AXLE_EDGE_CLEARED) {
+            radar_camera_release(0, CAMERA_RELEASE_EDGE);
+        }
+    }
+
+    while (!axle_detector_poll(&det, radar_now_us(), &vehicle_data)) {
+        k_usleep(MAX(axle_detector_poll_delay_us(&det, radar_now_us()), 100U));
+    }
+
+    vehicle_data.timestamp = radar_us_to_uptime_ms(vehicle_data.sensor2_us -
+                                                   vehicle_data.time_between_sensors_us);
+    vehicle_data.release_time = radar_us_to_uptime_ms(vehicle_data.ready_us);
+    vehicle_data.last_edge_time = radar_us_to_uptime_ms(vehicle_data.last_edge_us);
+    vehicle_data.lane = 0;
+    zassert_equal(radar_pipeline_submit(&vehicle_data), 0, "Fila de veiculos cheia");
+}
+
+void test_prearm_latency_under_load(void)
+{
+    traffic_vehicle_t vehicle = {
+        .speed_kmh = LOAD_TEST_SPEED_KMH,
+        .axle_count = 2,
+        .axle_spacing_mm = { 2600 },
+    };
+    uint32_t prearms_before = radar_camera_prearm_count();
+    uint32_t end = k_uptime_get_32() + LOAD_TEST_DURATION_MS;
+    int old_prio = k_thread_priority_get(k_current_get());
+
+    k_thread_priority_set(k_current_get(), RADAR_PRIO_SENSOR);
+
+    // Satura a fila de saída (display e câmera)
+    k_thread_create(&output_hog_thread, output_hog_stack, HOG_STACK_SIZE,
+                    output_hog, (void *)(uintptr_t)end, NULL, NULL,
+                    RADAR_PRIO_OUTPUT, 0, K_NO_WAIT);
+
+    for (int i = 0; i < LOAD_TEST_VEHICLES; i++) {
+        drive_vehicle(&vehicle);
+        k_msleep(LOAD_TEST_HEADWAY_MS);
+    }
+
+    k_thread_join(&output_hog_thread, K_FOREVER);
+    k_thread_priority_set(k_current_get(), old_prio);
+
+    uint32_t prearm_us = radar_camera_prearm_worst_us();
+    uint32_t trigger_us = radar_camera_trigger_worst_us();
+
+    // Sem pré-disparo, a câmera espera o último eixo liberar o sensor 2 e o
+    // silêncio que encerra o veículo, antes mesmo da decisão
+    uint32_t clearance_us = ((vehicle.axle_spacing_mm[0] + MAX_AXLE_SPACING_MM) * 3600U) /
+                            LOAD_TEST_SPEED_KMH;
+
+    // O acionamento pela decisão é o caminho sem pré-disparo: os dois são
+    // medidos na mesma execução, da mesma borda do sensor 2
+    TC_PRINT("Borda do sensor 2 -> camera armada a %d km/h sob carga:\n", LOAD_TEST_SPEED_KMH);
+    TC_PRINT("  Sem pre-disparo (decisao): pior %u us (encerramento do veiculo: %u us)\n",
+             trigger_us, clearance_us);
+    TC_PRINT("  Com pre-disparo:           pior %u us\n", prearm_us);
+
+    zassert_equal(radar_camera_prearm_count() - prearms_before, LOAD_TEST_VEHICLES,
+                  "Todo infrator deveria pre-armar a camera");
+    zassert_true(prearm_us < DEADLINE_DECISION_MS * 1000U,
+                 "Pre-disparo mais lento que o prazo de decisao");
+    zassert_true(trigger_us >= clearance_us,
+                 "Decisao nao pode acionar a camera antes do fim do veiculo");
+    zassert_true(prearm_us < trigger_us, "Pre-disparo nao antecipou a camera");
+}
+
+void test_infraction_prediction_suite(void)
+{
+    ztest_test_suite(radar_infraction_prediction_tests,
+        ztest_unit_test(test_transit_limit_exact_for_any_limit),
+        ztest_unit_test(test_transit_limit_matches_status),
+        ztest_unit_test(test_prediction_on_first_axle),
+        ztest_unit_test(test_prediction_refined_by_class),
+        ztest_unit_test(test_false_prearm_rate),
+        ztest_unit_test(test_dropped_prediction_reported),
+        ztest_unit_test(test_prearm_latency_under_load)
+    );
+    ztest_run_test_suite(radar_infraction_prediction_tests);
+}
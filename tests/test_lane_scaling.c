@@ -0,0 +1,154 @@
+#include <ztest.h>
+#include "radar.h"
+
+#if defined(CONFIG_GPIO_EMUL)
+#include <drivers/gpio/gpio_emul.h>
+#endif
+
+#define SCALING_VEHICLES_PER_LANE   200
+
+// Processamento de imagem embarcado simulado em cada veículo decidido
+#define SCALING_LOAD_US             500
+
+// Fração mínima do ganho ideal exigida com mais de uma CPU (%)
+#define SCALING_MIN_GAIN_PERCENT    50
+
+static void scaling_load(const vehicle_data_t *vehicle)
+{
+    ARG_UNUSED(vehicle);
+
+    k_busy_wait(SCALING_LOAD_US);
+}
+
+// Injeta veículos em todas as faixas e mede a vazão do estágio de decisão
+static uint32_t run_lane_benchmark(unsigned int num_cpus)
+{
+    uint32_t total = SCALING_VEHICLES_PER_LANE * RADAR_NUM_LANES;
+    uint32_t done_before = radar_deadline_completed(RADAR_STAGE_DECISION);
+    uint32_t start;
+    uint32_t elapsed;
+
+    radar_pipeline_pin_lanes(num_cpus);
+    start = k_uptime_get_32();
+
+    for (int i = 0; i < SCALING_VEHICLES_PER_LANE; i++) {
+        for (uint8_t lane = 0; lane < RADAR_NUM_LANES; lane++) {
+            vehicle_data_t vehicle = {
+                .timestamp = k_uptime_get_32(),
+                .release_time = k_uptime_get_32(),
+                .time_between_sensors = 100, // 18 km/h, sem infração
+                .axle_count = 2,
+                .type = VEHICLE_LIGHT,
+                .lane = lane
+            };
+
+            // Fila da faixa cheia: espera a decisão consumir
+            while (radar_pipeline_submit(&vehicle) == -ENOMSG) {
+                k_msleep(1);
+            }
+        }
+    }
+
+    while (radar_deadline_completed(RADAR_STAGE_DECISION) - done_before < total) {
+        k_msleep(1);
+    }
+
+    elapsed = MAX(k_uptime_get_32() - start, 1U);
+
+    return (total * 1000U) / elapsed;
+}
+
+void test_lane_scaling(void)
+{
+    uint32_t rate_single = 0;
+
+    TC_PRINT("Escalabilidade: %d faixa(s), %d CPU(s), carga sintetica %d us/veiculo\n",
+             RADAR_NUM_LANES, RADAR_NUM_CPUS, SCALING_LOAD_US);
+
+    radar_decision_set_test_hook(scaling_load);
+
+    for (unsigned int cpus = 1; cpus <= RADAR_NUM_CPUS; cpus++) {
+        uint32_t rate = run_lane_benchmark(cpus);
+
+        // A CPU com mais faixas limita a vazão: ganho ideal em centésimos
+        uint32_t used_cpus = MIN(cpus, (unsigned int)RADAR_NUM_LANES);
+        uint32_t lanes_per_cpu = (RADAR_NUM_LANES + used_cpus - 1U) / used_cpus;
+        uint32_t ideal_x100 = (RADAR_NUM_LANES * 100U) / lanes_per_cpu;
+
+        if (cpus == 1) {
+            rate_single = rate;
+        }
+
+        TC_PRINT("  %u CPU(s): %u veiculos/s (%u%% de 1 CPU, ideal %u%%)\n",
+                 cpus, rate, rate_single ? (rate * 100U) / rate_single : 0, ideal_x100);
+
+        zassert_true(rate > 0, "Nenhum veiculo decidido");
+
+        if (ideal_x100 > 100U) {
+            uint32_t min_x100 = 100U + ((ideal_x100 - 100U) * SCALING_MIN_GAIN_PERCENT) / 100U;
+
+            zassert_true(rate * 100U >= rate_single * min_x100,
+                         "%u CPU(s): %u veiculos/s, abaixo de %u%% de 1 CPU (%u veiculos/s)",
+                         cpus, rate, min_x100, rate_single);
+        }
+    }
+
+    radar_decision_set_test_hook(NULL);
+
+    // Restaura a distribuição padrão das faixas
+    radar_pipeline_pin_lanes(RADAR_NUM_CPUS);
+}
+
+#if defined(CONFIG_GPIO_EMUL)
+// Borda de descida em um pino do controlador emulado
+static void sensor_pulse(const struct device *dev, gpio_pin_t pin)
+{
+    gpio_emul_input_set(dev, pin, 1);
+    gpio_emul_input_set(dev, pin, 0);
+}
+
+// Um veículo de dois eixos a 36 km/h (10 mm/ms) pelo caminho real dos
+// sensores: controlador GPIO, interrupção, detector de eixos e decisão
+void test_lane_scaling_sensor_isr_path(void)
+{
+    const struct device *dev = DEVICE_DT_GET(RADAR_SENSOR_GPIO_NODE);
+    uint32_t done_before = radar_deadline_completed(RADAR_STAGE_DECISION);
+    uint32_t transit_ms = SENSOR_DISTANCE_MM / 10U;
+    uint32_t spacing_ms = 2600U / 10U;
+    uint32_t waited_ms = 0;
+
+    zassert_true(device_is_ready(dev), "Controlador dos sensores indisponivel");
+    zassert_true(radar_boot_armed_us() > 0, "Sensores nao armados no boot");
+
+    sensor_pulse(dev, SENSOR_1_PIN_LANE(0));
+    k_msleep(transit_ms);
+    sensor_pulse(dev, SENSOR_2_PIN_LANE(0));
+    k_msleep(spacing_ms - transit_ms);
+    sensor_pulse(dev, SENSOR_1_PIN_LANE(0));
+    k_msleep(transit_ms);
+    sensor_pulse(dev, SENSOR_2_PIN_LANE(0));
+
+    while (radar_deadline_completed(RADAR_STAGE_DECISION) == done_before &&
+           waited_ms < AXLE_TIMEOUT_MS + 1000U) {
+        k_msleep(10);
+        waited_ms += 10U;
+    }
+
+    zassert_equal(radar_deadline_completed(RADAR_STAGE_DECISION), done_before + 1,
+                  "Veiculo das bordas emuladas nao chegou a decisao");
+}
+#else
+void test_lane_scaling_sensor_isr_path(void)
+{
+    ztest_test_skip();
+}
+#endif
+
+void test_lane_scaling_suite(void)
+{
+    ztest_test_suite(radar_lane_scaling_tests,
+        ztest_unit_test(test_lane_scaling),
+        ztest_unit_test(test_lane_scaling_sensor_isr_path)
+    );
+    ztest_run_test_suite(radar_lane_scaling_tests);
+}
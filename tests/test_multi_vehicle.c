@@ -0,0 +1,213 @@
+#include <ztest.h>
+#include "radar.h"
+
+#define STREAM_VEHICLES     8
+#define MAX_STREAM_EDGES    (STREAM_VEHICLES * 4 * RADAR_MAX_AXLES)
+#define TEST_START_US       1000000U
+#define TEST_BOUNCE_US      1000U
+#define TEST_SPEED_MIN_KMH  10
+#define TEST_SPEED_MAX_KMH  250
+#define TEST_SPEED_STEP_KMH 20
+
+// Distância entre o último eixo de um veículo e o primeiro do seguinte:
+// abaixo da distância entre os sensores os veículos se sobrepõem; acima da
+// maior distância entre eixos há silêncio entre eles
+static const uint32_t test_gaps_mm[] = { 300, 8000 };
+
+// Entre as duas faixas acima o veículo seguinte parece um eixo a mais
+#define TEST_MID_BAND_GAP_MM  3000
+
+BUILD_ASSERT(TEST_MID_BAND_GAP_MM > SENSOR_DISTANCE_MM &&
+             TEST_MID_BAND_GAP_MM < MAX_AXLE_SPACING_MM,
+             "Espacamento intermediario fora da faixa entre eixos");
+
+static const traffic_vehicle_t test_profiles[] = {
+    { .axle_count = 2, .axle_spacing_mm = { 1200 } },
+    { .axle_count = 5, .axle_spacing_mm = { 3600, 1300, 5000, 1300 } },
+    { .axle_count = 2, .axle_spacing_mm = { 2600 } },
+    { .axle_count = 3, .axle_spacing_mm = { 4000, 1300 } },
+};
+
+static size_t drain(axle_detector_t *det, uint32_t now_us,
+                    vehicle_data_t *results, size_t count, size_t max_results)
+{
+    vehicle_data_t vehicle;
+
+    while (axle_detector_poll(det, now_us, &vehicle)) {
+        if (count < max_results) {
+            results[count] = vehicle;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+// Passa as bordas pelo detector como o sensor da faixa faria e devolve os
+// veículos na ordem em que foram entregues
+static size_t run_stream(axle_detector_t *det, const sensor_edge_t *edges, size_t count,
+                         vehicle_data_t *results, size_t max_results)
+{
+    size_t found = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        axle_detector_edge(det, edges[i].sensor, edges[i].time_us);
+        found = drain(det, edges[i].time_us, results, found, max_results);
+    }
+
+    uint32_t now_us = edges[count - 1].time_us;
+
+    while (det->count > 0) {
+        now_us += MAX(axle_detector_poll_delay_us(det, now_us), 1U);
+        found = drain(det, now_us, results, found, max_results);
+    }
+
+    return found;
+}
+
+static bool vehicle_matches(const traffic_vehicle_t *expected, vehicle_data_t *result)
+{
+    calculate_speed(result);
+
+    return result->axle_count == expected->axle_count &&
+           fabsf(result->speed_kmh - (float)expected->speed_kmh) <= expected->speed_kmh * 0.02f;
+}
+
+void test_dense_traffic_per_vehicle_accuracy(void)
+{
+    for (size_t g = 0; g < ARRAY_SIZE(test_gaps_mm); g++) {
+        uint32_t total = 0;
+        uint32_t correct = 0;
+
+        for (uint32_t speed = TEST_SPEED_MIN_KMH; speed <= TEST_SPEED_MAX_KMH;
+             speed += TEST_SPEED_STEP_KMH) {
+            traffic_vehicle_t vehicles[STREAM_VEHICLES];
+            vehicle_data_t results[STREAM_VEHICLES];
+            sensor_edge_t edges[MAX_STREAM_EDGES];
+            axle_detector_t det;
+
+            for (size_t i = 0; i < STREAM_VEHICLES; i++) {
+                vehicles[i] = test_profiles[i % ARRAY_SIZE(test_profiles)];
+                vehicles[i].speed_kmh = speed;
+                vehicles[i].bounce_us = TEST_BOUNCE_US;
+            }
+
+            size_t count = traffic_generate_stream(vehicles, STREAM_VEHICLES, test_gaps_mm[g],
+                                                   TEST_START_US, edges, MAX_STREAM_EDGES);
+
+            axle_detector_init(&det);
+            size_t found = run_stream(&det, edges, count, results, STREAM_VEHICLES);
+
+            zassert_equal(found, STREAM_VEHICLES, "Veiculos mesclados ou perdidos");
+            zassert_equal(det.dropped_tracks, 0, "Veiculo descartado");
+
+            for (size_t i = 0; i < STREAM_VEHICLES; i++) {
+                total++;
+                if (vehicle_matches(&vehicles[i], &results[i])) {
+                    correct++;
+                }
+            }
+        }
+
+        TC_PRINT("Espacamento de %u mm: %u/%u veiculos com eixos e velocidade corretos\n",
+                 test_gaps_mm[g], correct, total);
+        zassert_equal(correct, total, "Veiculo com eixos ou velocidade incorretos");
+    }
+}
+
+void test_vehicles_delivered_in_order(void)
+{
+    static const uint32_t speeds[] = { 60, 64, 56, 68 };
+    traffic_vehicle_t vehicles[ARRAY_SIZE(speeds)];
+    vehicle_data_t results[ARRAY_SIZE(speeds)];
+    sensor_edge_t edges[MAX_STREAM_EDGES];
+    axle_detector_t det;
+
+    // Velocidades próximas, mas distintas na tolerância de 2%, identificam
+    // cada veículo na saída
+    for (size_t i = 0; i < ARRAY_SIZE(speeds); i++) {
+        vehicles[i] = test_profiles[i];
+        vehicles[i].speed_kmh = speeds[i];
+    }
+
+    size_t count = traffic_generate_stream(vehicles, ARRAY_SIZE(vehicles), test_gaps_mm[0],
+                                           TEST_START_US, edges, MAX_STREAM_EDGES);
+
+    axle_detector_init(&det);
+    zassert_equal(run_stream(&det, edges, count, results, ARRAY_SIZE(results)),
+                  ARRAY_SIZE(vehicles), NULL);
+
+    for (size_t i = 0; i < ARRAY_SIZE(vehicles); i++) {
+        zassert_true(vehicle_matches(&vehicles[i], &results[i]), "Veiculo fora de ordem");
+    }
+}
+
+// Limite conhecido: com a distância entre veículos dentro da faixa de
+// distâncias entre eixos, os dois são entregues como um veículo só, com os
+// eixos de ambos e sem perda de eixos nem de velocidade
+void test_mid_band_gap_merges_vehicles(void)
+{
+    for (uint32_t speed = TEST_SPEED_MIN_KMH; speed <= TEST_SPEED_MAX_KMH;
+         speed += TEST_SPEED_STEP_KMH) {
+        traffic_vehicle_t vehicles[2] = { test_profiles[2], test_profiles[0] };
+        traffic_vehicle_t merged = {
+            .axle_count = vehicles[0].axle_count + vehicles[1].axle_count,
+            .speed_kmh = speed,
+        };
+        vehicle_data_t results[2];
+        sensor_edge_t edges[MAX_STREAM_EDGES];
+        axle_detector_t det;
+
+        for (size_t i = 0; i < ARRAY_SIZE(vehicles); i++) {
+            vehicles[i].speed_kmh = speed;
+            vehicles[i].bounce_us = TEST_BOUNCE_US;
+        }
+
+        size_t count = traffic_generate_stream(vehicles, ARRAY_SIZE(vehicles),
+                                               TEST_MID_BAND_GAP_MM, TEST_START_US,
+                                               edges, MAX_STREAM_EDGES);
+
+        axle_detector_init(&det);
+        zassert_equal(run_stream(&det, edges, count, results, ARRAY_SIZE(results)), 1,
+                      "Veiculos na faixa intermediaria deveriam ser mesclados");
+        zassert_equal(det.dropped_tracks, 0, "Veiculo descartado");
+        zassert_true(vehicle_matches(&merged, &results[0]), "Eixos ou velocidade perdidos");
+        zassert_within((float)results[0].axle_spacing_mm[vehicles[0].axle_count - 1],
+                       (float)TEST_MID_BAND_GAP_MM, TEST_MID_BAND_GAP_MM * 0.02f,
+                       "Distancia entre os veiculos deveria aparecer como entre eixos");
+    }
+}
+
+void test_abandoned_track_does_not_capture_next_vehicle(void)
+{
+    traffic_vehicle_t vehicle = test_profiles[0];
+    sensor_edge_t edges[MAX_STREAM_EDGES];
+    vehicle_data_t results[2];
+    axle_detector_t det;
+
+    vehicle.speed_kmh = 60;
+
+    // Eixo no sensor 1 que nunca chega ao sensor 2
+    axle_detector_init(&det);
+    zassert_true(axle_detector_edge(&det, RADAR_SENSOR_1, TEST_START_US), NULL);
+
+    // O próximo veículo chega depois do timeout, sem que a faixa tenha sido verificada
+    uint32_t next_us = TEST_START_US + AXLE_TIMEOUT_MS * 1000U;
+    size_t count = traffic_generate_edges(&vehicle, next_us, edges, MAX_STREAM_EDGES);
+
+    zassert_equal(run_stream(&det, edges, count, results, ARRAY_SIZE(results)), 1,
+                  "Veiculo abandonado nao deveria ser enviado");
+    zassert_true(vehicle_matches(&vehicle, &results[0]), NULL);
+    zassert_equal(det.dropped_tracks, 1, NULL);
+}
+
+void test_multi_vehicle_suite(void)
+{
+    ztest_test_suite(radar_multi_vehicle_tests,
+        ztest_unit_test(test_dense_traffic_per_vehicle_accuracy),
+        ztest_unit_test(test_vehicles_delivered_in_order),
+        ztest_unit_test(test_mid_band_gap_merges_vehicles),
+        ztest_unit_test(test_abandoned_track_does_not_capture_next_vehicle)
+    );
+    ztest_run_test_suite(radar_multi_vehicle_tests);
+}
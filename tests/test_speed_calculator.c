@@ -30,4 +30,12 @@ void test_main(void)
         ztest_unit_test(test_speed_status)
     );
     ztest_run_test_suite(radar_tests);
+
+    test_deadline_suite();
+    test_lane_scaling_suite();
+    test_axle_detector_suite();
+    test_multi_vehicle_suite();
+    test_doppler_suite();
+    test_vehicle_classifier_suite();
+    test_infraction_prediction_suite();
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include <ztest.h>
+#include "radar.h"
+#include "vehicle_classifier_heldout.h"
+
+#define MAX_TEST_EDGES          (2 * RADAR_MAX_AXLES)
+#define TEST_START_US           1000000U
+#define BENCH_ROUNDS            200
+#define MIN_MODEL_ACCURACY      90
+#define MAX_INFERENCE_NS        10000
+
+// Veículos reais do conjunto de avaliação fixo
+// (scripts/vehicle_classifier_heldout.csv, com a origem e o critério de
+// classe), fora do gerador usado no treino: avaliam o modelo em dados que ele
+// não viu. Erro conhecido do modelo atual: o Mercedes Accelo 815 sai LEVE,
+// porque com entre-eixos acima de 3306 mm a árvore decide por
+// length_mm <= 3795 e o treino não tem caminhão de 2 eixos abaixo de 3900 mm.
+typedef struct {
+    const char *name;
+    vehicle_type_t type;
+    traffic_vehicle_t vehicle;
+} real_vehicle_t;
+
+#define REAL_VEHICLE(name, type, speed, axles, ...) \
+    { name, type, { speed, axles, { __VA_ARGS__ } } },
+
+static const real_vehicle_t real_vehicles[] = {
+    CLASSIFIER_HELDOUT_VEHICLES(REAL_VEHICLE)
+};
+
+#define REAL_VEHICLES  ((uint32_t)ARRAY_SIZE(real_vehicles))
+#define BENCH_CALLS    (BENCH_ROUNDS * REAL_VEHICLES)
+
+// Passa um veículo pelo detector e calcula a velocidade, como o
+// sensor e o estágio de decisão fariam
+static bool measure_vehicle(const traffic_vehicle_t *vehicle, vehicle_data_t *result)
+{
+    axle_detector_t det;
+    sensor_edge_t edges[MAX_TEST_EDGES];
+    size_t count = traffic_generate_edges(vehicle, TEST_START_US, edges, MAX_TEST_EDGES);
+
+    axle_detector_init(&det);
+
+    for (size_t i = 0; i < count; i++) {
+        axle_detector_edge(&det, edges[i].sensor, edges[i].time_us);
+    }
+
+    uint32_t end_us = edges[count - 1].time_us +
+                      axle_detector_poll_delay_us(&det, edges[count - 1].time_us);
+
+    if (!axle_detector_poll(&det, end_us, result)) {
+        return false;
+    }
+
+    calculate_speed(result);
+    return true;
+}
+
+// Mede todos os veículos reais como o sensor e a decisão fariam
+static void measure_real_vehicles(vehicle_data_t *records)
+{
+    for (uint32_t n = 0; n < REAL_VEHICLES; n++) {
+        zassert_true(measure_vehicle(&real_vehicles[n].vehicle, &records[n]),
+                     "Veiculo nao detectado");
+        zassert_equal(records[n].axle_count, real_vehicles[n].vehicle.axle_count,
+                      "Contagem de eixos incorreta");
+    }
+}
+
+void test_classifier_accuracy(void)
+{
+    static vehicle_data_t records[ARRAY_SIZE(real_vehicles)];
+    uint32_t model_correct = 0;
+    uint32_t baseline_correct = 0;
+
+    measure_real_vehicles(records);
+
+    for (uint32_t n = 0; n < REAL_VEHICLES; n++) {
+        vehicle_type_t model = classify_vehicle_model(&records[n]);
+        vehicle_type_t baseline = classify_vehicle_axle_count(&records[n]);
+
+        model_correct += model == real_vehicles[n].type;
+        baseline_correct += baseline == real_vehicles[n].type;
+
+        if (model != real_vehicles[n].type || baseline != real_vehicles[n].type) {
+            TC_PRINT("  %-26s modelo %s, contagem de eixos %s\n", real_vehicles[n].name,
+                     model == real_vehicles[n].type ? "certo" : "errado",
+                     baseline == real_vehicles[n].type ? "certo" : "errado");
+        }
+    }
+
+    TC_PRINT("Classificacao de %u veiculos reais: modelo %u (%u%%), contagem de eixos %u (%u%%)\n",
+             REAL_VEHICLES, model_correct, model_correct * 100U / REAL_VEHICLES,
+             baseline_correct, baseline_correct * 100U / REAL_VEHICLES);
+
+    zassert_true(model_correct * 100U >= MIN_MODEL_ACCURACY * REAL_VEHICLES,
+                 "Acuracia do modelo abaixo do minimo");
+    zassert_true(model_correct > baseline_correct,
+                 "Modelo deveria superar a contagem de eixos");
+}
+
+void test_classifier_unknown_without_axles(void)
+{
+    vehicle_data_t vehicle = { .speed_kmh = 72.0f };
+
+    // Registros do radar Doppler não têm eixos nem distâncias
+    zassert_equal(classify_vehicle(&vehicle), VEHICLE_UNKNOWN, NULL);
+    zassert_equal(check_speed_status(MIN(SPEED_LIMIT_LIGHT, SPEED_LIMIT_HEAVY) + 1,
+                                     VEHICLE_UNKNOWN),
+                  SPEED_INFRACTION, "Veiculo sem classe deveria usar o limite mais baixo");
+}
+
+// A classe estimada na borda, com todos os eixos vistos, é a da decisão; com
+// só os dois primeiros eixos separa carros de caminhões de entre-eixos longo
+void test_classifier_partial_matches_final(void)
+{
+    static vehicle_data_t records[ARRAY_SIZE(real_vehicles)];
+    const uint16_t car[RADAR_MAX_AXLES - 1] = { 2600 };
+    const uint16_t truck[RADAR_MAX_AXLES - 1] = { 4300 };
+    uint32_t transit_us = SPEED_LIMIT_TRANSIT_US(60);
+
+    measure_real_vehicles(records);
+
+    for (uint32_t n = 0; n < REAL_VEHICLES; n++) {
+        zassert_equal(classify_vehicle_partial_model(records[n].axle_count,
+                                                     records[n].axle_spacing_mm,
+                                                     records[n].time_between_sensors_us),
+                      classify_vehicle_model(&records[n]),
+                      "%s: classe da borda diverge da decisao", real_vehicles[n].name);
+    }
+
+    zassert_equal(classify_vehicle_partial_model(2, car, transit_us), VEHICLE_LIGHT, NULL);
+    zassert_equal(classify_vehicle_partial_model(2, truck, transit_us), VEHICLE_HEAVY, NULL);
+
+    // Um eixo não separa as classes; dois eixos só separam pelo modelo
+    zassert_equal(classify_vehicle_partial(1, car, transit_us), VEHICLE_UNKNOWN, NULL);
+    zassert_equal(classify_vehicle_partial(2, car, transit_us),
+                  CLASSIFICATION_BY_MODEL ? VEHICLE_LIGHT : VEHICLE_UNKNOWN, NULL);
+}
+
+// Custo de uma inferência, comparado à classificação por contagem de eixos
+void test_classifier_benchmark(void)
+{
+    static vehicle_data_t records[ARRAY_SIZE(real_vehicles)];
+    volatile vehicle_type_t sink;
+    uint32_t start;
+    uint32_t model_cycles;
+    uint32_t baseline_cycles;
+
+    measure_real_vehicles(records);
+
+    start = k_cycle_get_32();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t n = 0; n < REAL_VEHICLES; n++) {
+            sink = classify_vehicle_model(&records[n]);
+        }
+    }
+    model_cycles = k_cycle_get_32() - start;
+
+    start = k_cycle_get_32();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t n = 0; n < REAL_VEHICLES; n++) {
+            sink = classify_vehicle_axle_count(&records[n]);
+        }
+    }
+    baseline_cycles = k_cycle_get_32() - start;
+
+    ARG_UNUSED(sink);
+
+    uint32_t model_ns = (uint32_t)(k_cyc_to_ns_floor64(model_cycles) / BENCH_CALLS);
+
+    TC_PRINT("Inferencia: modelo %u.%02u ciclos (%u ns), contagem de eixos %u.%02u ciclos "
+             "por veiculo\n",
+             model_cycles / BENCH_CALLS, (model_cycles % BENCH_CALLS) * 100U / BENCH_CALLS,
+             model_ns, baseline_cycles / BENCH_CALLS,
+             (baseline_cycles % BENCH_CALLS) * 100U / BENCH_CALLS);
+
+    // CLASSIFIER_DEPTH comparações e a montagem dos atributos: poucos
+    // microssegundos mesmo em um Cortex-M3 sem FPU
+    zassert_true(model_ns < MAX_INFERENCE_NS, "Inferencia mais lenta que o esperado");
+}
+
+void test_vehicle_classifier_suite(void)
+{
+    ztest_test_suite(radar_vehicle_classifier_tests,
+        ztest_unit_test(test_classifier_accuracy),
+        ztest_unit_test(test_classifier_unknown_without_axles),
+        ztest_unit_test(test_classifier_partial_matches_final),
+        ztest_unit_test(test_classifier_benchmark)
+    );
+    ztest_run_test_suite(radar_vehicle_classifier_tests);
+}
@@ -0,0 +1,152 @@
+#include "radar.h"
+
+// Tempo em us para percorrer distance_mm a speed_kmh
+static uint32_t traffic_travel_us(uint32_t distance_mm, uint32_t speed_kmh)
+{
+    return (uint32_t)(((uint64_t)distance_mm * 3600U) / speed_kmh);
+}
+
+static size_t traffic_add_edge(sensor_edge_t *edges, size_t count, size_t max_edges,
+                               radar_sensor_t sensor, uint32_t time_us)
+{
+    if (count >= max_edges) {
+        return count;
+    }
+
+    // Inserção ordenada por tempo
+    size_t pos = count;
+
+    while (pos > 0 && (int32_t)(edges[pos - 1].time_us - time_us) > 0) {
+        edges[pos] = edges[pos - 1];
+        pos--;
+    }
+
+    edges[pos].time_us = time_us;
+    edges[pos].sensor = sensor;
+
+    return count + 1;
+}
+
+// Acrescenta, em ordem de tempo, as bordas que um veículo produz nos dois
+// sensores. Retorna o novo total de bordas; last_axle_us recebe o tempo em
+// que o último eixo passa pelo sensor 1.
+static size_t traffic_add_vehicle(const traffic_vehicle_t *vehicle, uint32_t start_us,
+                                  sensor_edge_t *edges, size_t count, size_t max_edges,
+                                  uint32_t *last_axle_us)
+{
+    uint32_t transit_us = traffic_travel_us(SENSOR_DISTANCE_MM, vehicle->speed_kmh);
+    uint32_t axle_us = start_us;
+
+    for (uint8_t axle = 0; axle < vehicle->axle_count && axle < RADAR_MAX_AXLES; axle++) {
+        if (axle > 0) {
+            axle_us += traffic_travel_us(vehicle->axle_spacing_mm[axle - 1], vehicle->speed_kmh);
+        }
+
+        count = traffic_add_edge(edges, count, max_edges, RADAR_SENSOR_1, axle_us);
+        count = traffic_add_edge(edges, count, max_edges, RADAR_SENSOR_2, axle_us + transit_us);
+
+        if (vehicle->bounce_us > 0) {
+            count = traffic_add_edge(edges, count, max_edges, RADAR_SENSOR_1,
+                                     axle_us + vehicle->bounce_us);
+            count = traffic_add_edge(edges, count, max_edges, RADAR_SENSOR_2,
+                                     axle_us + transit_us + vehicle->bounce_us);
+        }
+    }
+
+    *last_axle_us = axle_us;
+
+    return count;
+}
+
+// Gera as bordas de um único veículo
+size_t traffic_generate_edges(const traffic_vehicle_t *vehicle, uint32_t start_us,
+                              sensor_edge_t *edges, size_t max_edges)
+{
+    uint32_t last_axle_us;
+
+    if (vehicle->speed_kmh == 0) {
+        return 0;
+    }
+
+    return traffic_add_vehicle(vehicle, start_us, edges, 0, max_edges, &last_axle_us);
+}
+
+// Gera as bordas de uma fila de veículos. gap_mm é a distância entre o último
+// eixo de um veículo e o primeiro eixo do seguinte; abaixo da distância entre
+// os sensores, o veículo seguinte chega ao sensor 1 antes de o anterior
+// liberar o sensor 2.
+size_t traffic_generate_stream(const traffic_vehicle_t *vehicles, size_t vehicle_count,
+                               uint32_t gap_mm, uint32_t start_us,
+                               sensor_edge_t *edges, size_t max_edges)
+{
+    uint32_t vehicle_start_us = start_us;
+    uint32_t last_axle_us;
+    size_t count = 0;
+
+    for (size_t i = 0; i < vehicle_count; i++) {
+        if (vehicles[i].speed_kmh == 0) {
+            continue;
+        }
+
+        count = traffic_add_vehicle(&vehicles[i], vehicle_start_us, edges, count, max_edges,
+                                    &last_axle_us);
+        vehicle_start_us = last_axle_us + traffic_travel_us(gap_mm, vehicles[i].speed_kmh);
+    }
+
+    return count;
+}
+
+// Desvio Doppler de um alvo a speed_kmh: f = 2 * v * f0 / c
+static float traffic_doppler_hz(uint32_t speed_kmh)
+{
+    return (speed_kmh / 3.6f) * 2.0f * (DOPPLER_CARRIER_MHZ * 1e6f) / 299792458.0f;
+}
+
+void traffic_iq_init(traffic_iq_t *gen, const traffic_doppler_t *target)
+{
+    double cycles_per_sample = traffic_doppler_hz(target->speed_kmh) / DOPPLER_SAMPLE_RATE_HZ;
+
+    memset(gen, 0, sizeof(*gen));
+    gen->target = *target;
+    gen->phase_step = (uint32_t)(cycles_per_sample * 4294967296.0);
+    gen->beam_samples = (uint32_t)(((uint64_t)target->beam_ms * DOPPLER_SAMPLE_RATE_HZ) / 1000U);
+    gen->noise_state = 0x2545F491U;
+}
+
+// Ruído uniforme em [-amplitude, amplitude] (xorshift32)
+static int32_t traffic_noise(traffic_iq_t *gen)
+{
+    uint32_t x = gen->noise_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    gen->noise_state = x;
+
+    return (int32_t)((int64_t)(int32_t)x * gen->target.noise / INT32_MAX);
+}
+
+// Gera amostras IQ intercaladas: o eco do veículo enquanto ele está no feixe
+// e apenas ruído depois. Veículos se afastando têm frequência negativa.
+void traffic_iq_generate(traffic_iq_t *gen, radar_q15_t *iq, size_t samples)
+{
+    const float rad_per_step = 2.0f * 3.14159265f / 4294967296.0f;
+
+    for (size_t n = 0; n < samples; n++) {
+        int32_t re = traffic_noise(gen);
+        int32_t im = traffic_noise(gen);
+
+        if (gen->sample < gen->beam_samples) {
+            float angle = gen->phase * rad_per_step;
+
+            re += (int32_t)(gen->target.amplitude * cosf(angle));
+            im += (int32_t)(gen->target.amplitude * sinf(angle)) *
+                  (gen->target.receding ? -1 : 1);
+            gen->phase += gen->phase_step;
+        }
+
+        iq[2 * n] = (radar_q15_t)CLAMP(re, INT16_MIN, INT16_MAX);
+        iq[2 * n + 1] = (radar_q15_t)CLAMP(im, INT16_MIN, INT16_MAX);
+        gen->sample++;
+    }
+}